@@ -26,6 +26,7 @@
 #include "robotis_manipulator_log.h"
 
 #include <algorithm>
+#include <atomic>
 
 namespace robotis_manipulator
 {
@@ -34,6 +35,16 @@ namespace robotis_manipulator
 #define DYNAMICS_GRAVITY_ONLY 1
 #define DYNAMICS_NOT_SOVING 2
 
+typedef struct _ActuatorRoute
+{
+  JointActuator *actuator;
+  std::vector<uint8_t> actuator_id;             // IDs of the actuator that drive an active joint
+  std::vector<uint8_t> component_index;         // active joint slot of each ID
+  std::vector<double> inverse_coefficient;
+  std::vector<double> inverse_torque_coefficient;
+  std::vector<ActuatorValue> value;             // send buffer
+} ActuatorRoute;
+
 class RobotisManipulator
 {
 private:
@@ -43,6 +54,10 @@ private:
   Dynamics *dynamics_;
   std::map<Name, JointActuator *> joint_actuator_;
   std::map<Name, ToolActuator *> tool_actuator_;
+  std::vector<ActuatorIdEntry> actuator_id_table_;   // indexed by actuator ID
+  uint32_t actuator_id_table_revision_;              // model revision the table was built from
+  std::vector<ActuatorRoute> actuator_route_;        // one per joint actuator
+  uint32_t actuator_route_revision_;                 // model revision the route was built from
 
   bool trajectory_initialized_state_;
   bool moving_state_;
@@ -54,12 +69,39 @@ private:
   bool kinematics_added_state_;
   bool dynamics_added_state_;
 
+  double baking_control_period_;
+  int baking_option_;
+  bool trajectory_table_state_;
+  TrajectoryTable trajectory_table_;
+  bool joint_limit_validated_state_;
+
+  bool task_compile_state_;
+  double task_compile_knot_time_;
+  double task_compile_tolerance_;
+
+  // Retarget slot, written by any thread and taken by the control thread
+  std::atomic<uint8_t> retarget_state_;
+  std::vector<double> retarget_goal_joint_position_;
+  double retarget_move_time_;
+
 private:
-  void startMoving();
+  void updateActuatorIdTable();
+  void updateActuatorRoute();
+  bool startMoving();
+  bool checkJointTrajectoryLimit();
+  bool compileTaskTrajectory();
+  bool solveTaskKnot(double tick_time, JointWaypoint seed_way_point, JointWaypoint *knot_way_point);
+  void applyJointRetarget();
+  bool bakeTrajectory();
   JointWaypoint getTrajectoryJointValue(double tick_time, int option=0);
 
 public:
   RobotisManipulator();
+  /**
+   * @brief RobotisManipulator copies a retarget that is ready, one being written or taken is left to the original
+   */
+  RobotisManipulator(const RobotisManipulator &robotis_manipulator);
+  RobotisManipulator &operator=(const RobotisManipulator &robotis_manipulator);
   virtual ~RobotisManipulator();
 
 
@@ -114,6 +156,14 @@ public:
   Manipulator *getManipulator();
 
   void setTorqueCoefficient(Name component_name, double torque_coefficient);
+  /**
+   * @brief setJointDynamicLimit limits used by makeJointSCurveTrajectory
+   * @param component_name
+   * @param velocity_limit
+   * @param acceleration_limit
+   * @param jerk_limit
+   */
+  void setJointDynamicLimit(Name component_name, double velocity_limit, double acceleration_limit, double jerk_limit);
 
   JointValue getJointValue(Name joint_name);
   JointValue getToolValue(Name tool_name);
@@ -189,13 +239,35 @@ public:
   *****************************************************************************/
   bool checkJointLimit(Name component_name, double position);
   bool checkJointLimit(Name component_name, JointValue value);
-  bool checkJointLimit(std::vector<Name> component_name, std::vector<double> position_vector);
-  bool checkJointLimit(std::vector<Name> component_name, std::vector<JointValue> value_vector);
+  bool checkJointLimit(const std::vector<Name> &component_name, const std::vector<double> &position_vector);
+  bool checkJointLimit(const std::vector<Name> &component_name, const std::vector<JointValue> &value_vector);
 
   /*****************************************************************************
   ** Trajectory Control Fuction
   *****************************************************************************/
   Trajectory *getTrajectory();
+  /**
+   * @brief setTrajectoryBaking sample every following trajectory into a table when it is made,
+   *        IK, limit check and dynamics are solved there instead of in the control tick
+   * @param control_period period of the control tick, 0.0 disables baking
+   * @param option dynamics option used while baking
+   */
+  void setTrajectoryBaking(double control_period, int option=DYNAMICS_ALL_SOVING);
+  /**
+   * @brief setTaskTrajectoryCompileOption solve IK along every following task trajectory when it is made
+   *        and run it as a C2 joint spline, so the control tick does not solve IK
+   * @param enable
+   * @param knot_time initial time between spline knots
+   * @param tolerance allowed tool error between knots [m, rad], knots are added until it is met
+   */
+  void setTaskTrajectoryCompileOption(bool enable, double knot_time=0.05, double tolerance=0.001);
+  /**
+   * @brief setSpeedOverride scales the time base of the present and following trajectories
+   * @param speed_override 0.0 (pause) to 2.0, 1.0 is the planned speed
+   * @param ramp_rate change of the scale per second, 0.0 to change at once
+   */
+  void setSpeedOverride(double speed_override, double ramp_rate=1.0);
+  double getSpeedOverride();
   /**
    * @brief makeJointTrajectoryFromPresentPosition
    * @param delta_goal_joint_position
@@ -217,6 +289,27 @@ public:
    * @param present_joint_value
    */
   bool makeJointTrajectory(std::vector<JointValue> goal_joint_value, double move_time, std::vector<JointValue> present_joint_value = {});
+  /**
+   * @brief makeJointTrajectory
+   * @param via_joint_position intermediate joint positions followed by the goal joint position
+   * @param move_time time of each segment
+   * @param present_joint_value
+   */
+  bool makeJointTrajectory(std::vector<std::vector<double>> via_joint_position, std::vector<double> move_time, std::vector<JointValue> present_joint_value = {});
+  /**
+   * @brief makeJointSCurveTrajectory shortest synchronized move within the joint dynamic limits
+   * @param goal_joint_position
+   * @param present_joint_value
+   */
+  bool makeJointSCurveTrajectory(std::vector<double> goal_joint_position, std::vector<JointValue> present_joint_value = {});
+  /**
+   * @brief retargetJointTrajectory replaces the present move at the next getJointGoalValueFromTrajectory call,
+   *        starting from the present position, velocity and acceleration. Never blocks, safe from another thread.
+   * @param goal_joint_position
+   * @param move_time
+   * @return false if the control thread is taking the previous target, try again later
+   */
+  bool retargetJointTrajectory(std::vector<double> goal_joint_position, double move_time);
   /**
    * @brief makeJointTrajectory
    * @param tool_name
@@ -289,6 +382,54 @@ public:
    * @param present_joint_value
    */
   bool makeTaskTrajectory(Name tool_name, KinematicPose goal_pose, double move_time, std::vector<JointValue> present_joint_value = {});
+  /**
+   * @brief makeTaskTrajectory
+   * @param tool_name
+   * @param via_pose intermediate poses followed by the goal pose
+   * @param move_time time of each segment
+   * @param present_joint_value
+   */
+  bool makeTaskTrajectory(Name tool_name, std::vector<KinematicPose> via_pose, std::vector<double> move_time, std::vector<JointValue> present_joint_value = {});
+  /**
+   * @brief makeTaskLineTrajectory straight line at constant tool speed, orientation is kept
+   * @param tool_name
+   * @param goal_position
+   * @param move_time
+   * @param present_joint_value
+   */
+  bool makeTaskLineTrajectory(Name tool_name, Eigen::Vector3d goal_position, double move_time, std::vector<JointValue> present_joint_value = {});
+  /**
+   * @brief makeTaskArcTrajectory circular arc at constant tool speed, orientation is kept
+   * @param tool_name
+   * @param center any point on the rotation axis
+   * @param axis
+   * @param angle positive counterclockwise about the axis
+   * @param move_time
+   * @param present_joint_value
+   */
+  bool makeTaskArcTrajectory(Name tool_name, Eigen::Vector3d center, Eigen::Vector3d axis, double angle, double move_time, std::vector<JointValue> present_joint_value = {});
+  /**
+   * @brief makeTaskHelixTrajectory helix at constant tool speed, orientation is kept
+   * @param tool_name
+   * @param center any point on the rotation axis
+   * @param axis
+   * @param angle positive counterclockwise about the axis
+   * @param pitch advance along the axis per turn
+   * @param move_time
+   * @param present_joint_value
+   */
+  bool makeTaskHelixTrajectory(Name tool_name, Eigen::Vector3d center, Eigen::Vector3d axis, double angle, double pitch, double move_time, std::vector<JointValue> present_joint_value = {});
+  /**
+   * @brief setTaskPathAccelerationTimeRatio
+   * @param acceleration_time_ratio share of the move time spent speeding up and slowing down each, 0.2 by default
+   */
+  void setTaskPathAccelerationTimeRatio(double acceleration_time_ratio);
+
+  /**
+   * @brief setTaskOrientationInterpolation used by the task trajectories made after this call
+   * @param orientation_interpolation RPY_INTERPOLATION (default) or SLERP_INTERPOLATION
+   */
+  void setTaskOrientationInterpolation(OrientationInterpolation orientation_interpolation);
 
   /**
    * @brief setCustomTrajectoryOption
@@ -32,6 +32,8 @@
 #include <vector>
 //#include <map>
 #include <map>
+#include <memory>
+#include <iterator>
 #include "robotis_manipulator_math.h"
 #include "robotis_manipulator_log.h"
 
@@ -96,9 +98,28 @@ typedef enum _TrajectoryType
   JOINT_TRAJECTORY,
   TASK_TRAJECTORY,
   CUSTOM_JOINT_TRAJECTORY,
-  CUSTOM_TASK_TRAJECTORY
+  CUSTOM_TASK_TRAJECTORY,
+  JOINT_S_CURVE_TRAJECTORY,
+  TASK_PATH_TRAJECTORY
 } TrajectoryType;
 
+typedef enum _OrientationInterpolation
+{
+  RPY_INTERPOLATION = 0,
+  SLERP_INTERPOLATION
+} OrientationInterpolation;
+
+typedef struct _TrajectoryTable
+{
+  double control_period;
+  uint32_t joint_size;
+  uint32_t sample_size;
+  std::vector<double> position;       // [sample * joint_size + joint]
+  std::vector<double> velocity;
+  std::vector<double> acceleration;
+  std::vector<double> effort;
+} TrajectoryTable;
+
 typedef struct _Point
 {
   double position;
@@ -147,6 +168,9 @@ typedef struct _JointConstant
   double coefficient;             // joint angle over actuator angle
   Limit position_limit;
   double torque_coefficient;      // torque over current
+  double velocity_limit;          // 0.0 if not set
+  double acceleration_limit;      // 0.0 if not set
+  double jerk_limit;              // 0.0 if not set
 } JointConstant;
 
 typedef struct _World
@@ -172,6 +196,56 @@ typedef struct _Component
   Name actuator_name;
 } Component;
 
+// Constant part of a component, shared through the ManipulatorModel
+typedef struct _ComponentModel
+{
+  ChainingName name;
+  ComponentType component_type;
+  Relative relative;
+  JointConstant joint_constant;
+  Name actuator_name;
+} ComponentModel;
+
+// Variable part of a component, owned by each Manipulator
+typedef struct _ComponentState
+{
+  Pose pose_from_world;
+  JointValue joint_value;
+} ComponentState;
+
+// Everything about the robot that does not change while it moves. Copies of a Manipulator
+// share one model and a Manipulator copies it only before changing it, so a shared model is
+// never written and can be read from several threads.
+typedef struct _ManipulatorModel
+{
+  uint32_t revision;                      // unique for each model content
+
+  // Components in contiguous slots: active joints [0, passive_joint_begin), passive joints
+  // [passive_joint_begin, tool_begin) and tools [tool_begin, end), each group in name order.
+  std::vector<ComponentModel> component;
+  std::vector<Name> component_name;
+  std::map<Name, uint8_t> component_index;
+  uint8_t passive_joint_begin;
+  uint8_t tool_begin;
+  std::vector<uint8_t> joint_index;       // slots of every joint in name order
+  std::vector<int16_t> parent_index;      // slot of each parent, -1 below the world
+
+  // Views rebuilt whenever the components change
+  std::vector<uint8_t> active_joint_index;
+  std::vector<Name> active_joint_name;
+  std::vector<Name> tool_name;
+  std::vector<uint8_t> joint_id;
+  std::vector<uint8_t> active_joint_id;
+  int16_t id_index[256];                  // first slot in name order using each ID, -1 if none
+} ManipulatorModel;
+
+typedef struct _ActuatorIdEntry
+{
+  int16_t component_index;        // -1 if no active joint uses the ID
+  double coefficient;
+  double torque_coefficient;
+} ActuatorIdEntry;
+
 /*****************************************************************************
 ** External environment parameter Set
 *****************************************************************************/
@@ -200,12 +274,31 @@ typedef struct _Moment
 /*****************************************************************************
 ** Manipulator Class
 *****************************************************************************/
+class ComponentIterator;
+
 class Manipulator
 {
 private:
-  int8_t dof_;
   World world_;
-  std::map<Name, Component> component_;
+  std::shared_ptr<ManipulatorModel> model_;   // never written while shared
+  std::vector<ComponentState> state_;         // per slot of the model
+
+  // Forward kinematics bookkeeping. Every joint position change, chain change and pose write
+  // takes a new state version. Joint velocities are not tracked, so only Kinematics::isPositionOnly() solvers skip on it.
+  uint64_t state_version_;
+  uint64_t solved_state_version_;         // state_version_ at the last markForwardKinematicsSolved()
+  uint64_t chain_stamp_;                  // last change of the world pose or of the chain
+  std::vector<uint64_t> joint_stamp_;     // per slot, last change of its joint position
+  std::vector<uint64_t> pose_stamp_;      // per slot, last write of its pose
+
+  ManipulatorModel *editModel();
+  void insertComponent(Name component_name, Component component);
+  void updateComponentLayout(ManipulatorModel *model);
+  void updateComponentView(ManipulatorModel *model);
+  void writeJointPosition(uint8_t index, double position);
+  void writeJointValue(uint8_t index, const JointValue &joint_value);
+  void touchPose(uint8_t index);
+  void touchChain();
 
 public:
   Manipulator();
@@ -255,6 +348,7 @@ public:
   ** Set Function
   *****************************************************************************/
   void setTorqueCoefficient(Name component_name, double torque_coefficient);
+  void setJointDynamicLimit(Name component_name, double velocity_limit, double acceleration_limit, double jerk_limit);
 
   void setWorldPose(Pose world_pose);
   void setWorldKinematicPose(KinematicPose world_kinematic_pose);
@@ -300,8 +394,13 @@ public:
   DynamicPose getWorldDynamicPose();
   int8_t getComponentSize();
   std::map<Name, Component> getAllComponent();
-  std::map<Name, Component>::iterator getIteratorBegin();
-  std::map<Name, Component>::iterator getIteratorEnd();
+  /**
+   * @brief getIteratorBegin iterates the components in name order, first is the name and second a copy of the component
+   */
+  ComponentIterator getIteratorBegin() const;
+  ComponentIterator getIteratorEnd() const;
+  uint8_t getComponentIndex(Name component_name);
+  Name getComponentName(uint8_t component_index);
   Component getComponent(Name component_name);
   Name getComponentActuatorName(Name component_name);
   Name getComponentParentName(Name component_name);
@@ -318,6 +417,9 @@ public:
   int8_t getId(Name component_name);
   double getCoefficient(Name component_name);
   double getTorqueCoefficient(Name component_name);
+  double getVelocityLimit(Name component_name);
+  double getAccelerationLimit(Name component_name);
+  double getJerkLimit(Name component_name);
   Eigen::Vector3d getAxis(Name component_name);
   double getJointPosition(Name component_name);
   double getJointVelocity(Name component_name);
@@ -336,10 +438,12 @@ public:
   std::vector<double> getAllToolPosition();
   std::vector<JointValue> getAllToolValue();
 
-  std::vector<uint8_t> getAllJointID();
-  std::vector<uint8_t> getAllActiveJointID();
-  std::vector<Name> getAllToolComponentName();
-  std::vector<Name> getAllActiveJointComponentName();
+  const std::vector<uint8_t> &getAllJointID();
+  const std::vector<uint8_t> &getAllActiveJointID();
+  const std::vector<Name> &getAllToolComponentName();
+  const std::vector<Name> &getAllActiveJointComponentName();
+  const std::vector<uint8_t> &getAllJointIndex();
+  const std::vector<uint8_t> &getAllActiveJointIndex();
 
 
   /*****************************************************************************
@@ -353,6 +457,116 @@ public:
   ** Find Function
   *****************************************************************************/
   Name findComponentNameUsingId(int8_t id);
+  int16_t findComponentIndexUsingId(int8_t id);
+
+
+  /*****************************************************************************
+  ** Forward Kinematics State
+  *****************************************************************************/
+  /**
+   * @brief getStateVersion changes whenever a joint position, the chain or a component pose changes
+   */
+  uint64_t getStateVersion() const;
+  /**
+   * @brief isForwardKinematicsSolved
+   * @return true if nothing changed since the last markForwardKinematicsSolved()
+   */
+  bool isForwardKinematicsSolved() const;
+  /**
+   * @brief isComponentPoseOutdated lets forward kinematics solvers recompute only the subtrees below changed joints
+   * @param component_name
+   * @return true if the component or one of its parents moved, or its pose was overwritten,
+   *         since the last markForwardKinematicsSolved()
+   */
+  bool isComponentPoseOutdated(Name component_name) const;
+  /**
+   * @brief isComponentStateOutdatedUsingIndex same as isComponentPoseOutdated() without walking up the parents,
+   *        for solvers that visit every parent before its children
+   * @param component_index
+   * @return true if the chain, the joint position or the pose of this slot changed since the last markForwardKinematicsSolved()
+   */
+  bool isComponentStateOutdatedUsingIndex(uint8_t component_index) const;
+  /**
+   * @brief markForwardKinematicsSolved every component pose now matches the joint positions
+   */
+  void markForwardKinematicsSolved();
+  /**
+   * @brief invalidateForwardKinematics e.g. when the kinematics solver is replaced
+   */
+  void invalidateForwardKinematics();
+
+
+  /*****************************************************************************
+  ** Model
+  *****************************************************************************/
+  /**
+   * @brief getModel constant robot description shared by the copies of this manipulator
+   */
+  std::shared_ptr<const ManipulatorModel> getModel() const;
+  /**
+   * @brief getModelRevision equal revisions mean the same model, any change of the model changes it
+   */
+  uint32_t getModelRevision() const;
+  /**
+   * @brief getComponentStateUsingIndex pose and joint value of a component slot of getModel()
+   */
+  const ComponentState &getComponentStateUsingIndex(uint8_t component_index) const;
+  /**
+   * @brief getComponentUsingIndex getComponent() for a component slot of getModel()
+   */
+  Component getComponentUsingIndex(uint8_t component_index) const;
+  /**
+   * @brief getComponentUsingIndex assigns into component, reusing the storage of its names
+   * @param component_index
+   * @param component
+   */
+  void getComponentUsingIndex(uint8_t component_index, Component *component) const;
+  /**
+   * @brief setComponentKinematicPoseUsingIndex setComponentKinematicPoseFromWorld() for a component slot of getModel()
+   */
+  void setComponentKinematicPoseUsingIndex(uint8_t component_index, const KinematicPose &pose_to_world);
+  /**
+   * @brief setJointPositionUsingIndex setJointPosition() for a component slot of getModel()
+   */
+  void setJointPositionUsingIndex(uint8_t component_index, double position);
+};
+
+/**
+ * @brief ComponentIterator read only iterator over the components of a Manipulator in name order, used like the
+ *        former std::map<Name, Component>::iterator: first is the name and second a copy of the component.
+ *        The pair is a member rebuilt in place on the first access after each increment, so a reference to it is
+ *        valid until the iterator moves. Components are changed through the Manipulator setters, and not while
+ *        iterating.
+ */
+class ComponentIterator
+{
+public:
+  typedef std::forward_iterator_tag iterator_category;
+  typedef std::pair<Name, Component> value_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef const value_type *pointer;
+  typedef const value_type &reference;
+
+private:
+  const Manipulator *manipulator_;
+  std::map<Name, uint8_t>::const_iterator it_;
+  mutable value_type value_;
+  mutable bool value_valid_;                         // value_ holds the component of it_
+
+public:
+  ComponentIterator(const Manipulator *manipulator, std::map<Name, uint8_t>::const_iterator it);
+
+  reference operator*() const;
+  pointer operator->() const;
+  ComponentIterator &operator++();
+  ComponentIterator operator++(int);
+  bool operator==(const ComponentIterator &other) const;
+  bool operator!=(const ComponentIterator &other) const;
+
+  /**
+   * @brief getComponentIndex component slot of Manipulator::getModel(), for the index based accessors
+   */
+  uint8_t getComponentIndex() const;
 };
 
 }
@@ -0,0 +1,229 @@
+/*******************************************************************************
+* Copyright 2018 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/* Authors: Darby Lim, Hye-Jong KIM, Ryan Shim, Yong-Ho Na */
+
+#ifndef ROBOTIS_MANIPULATOR_FIXED_H_
+#define ROBOTIS_MANIPULATOR_FIXED_H_
+
+// Fixed-DOF fast path alongside the dynamic-size API.
+// Every type has its size known at compile time, so nothing here allocates on the heap.
+
+#if defined(__OPENCR__)
+  #include <Eigen.h>  // Calls main Eigen matrix class library
+  #include <Eigen/LU> // Calls inverse, determinant, LU decomp., etc.
+#else
+  #include <eigen3/Eigen/Eigen>
+  #include <eigen3/Eigen/LU>
+#endif
+
+#include "robotis_manipulator_common.h"
+#include "robotis_manipulator_math.h"
+#include "robotis_manipulator_trajectory_generator.h"
+
+namespace robotis_manipulator
+{
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+template <int DOF>
+struct FixedJointWaypoint
+{
+  typedef Eigen::Matrix<double, DOF, 1> Vector;
+
+  Vector position;
+  Vector velocity;
+  Vector acceleration;
+  Vector effort;
+
+  FixedJointWaypoint()
+    : position(Vector::Zero()), velocity(Vector::Zero()), acceleration(Vector::Zero()), effort(Vector::Zero()) {}
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+/*****************************************************************************
+** Conversion from and to the dynamic-size API
+*****************************************************************************/
+/**
+ * @brief convertJointWaypoint
+ * @param joint_way_point
+ * @param fixed_joint_way_point
+ * @return false if the size is not DOF
+ */
+template <int DOF>
+bool convertJointWaypoint(const JointWaypoint &joint_way_point, FixedJointWaypoint<DOF> *fixed_joint_way_point)
+{
+  if (joint_way_point.size() != DOF)
+  {
+    log::error("[convertJointWaypoint] Wrong joint size.");
+    return false;
+  }
+  for (int index = 0; index < DOF; index++)
+  {
+    fixed_joint_way_point->position(index) = joint_way_point[index].position;
+    fixed_joint_way_point->velocity(index) = joint_way_point[index].velocity;
+    fixed_joint_way_point->acceleration(index) = joint_way_point[index].acceleration;
+    fixed_joint_way_point->effort(index) = joint_way_point[index].effort;
+  }
+  return true;
+}
+
+/**
+ * @brief convertJointWaypoint
+ * @param fixed_joint_way_point
+ * @param joint_way_point caller-owned buffer, e.g. for the actuators, only resized when its size is not DOF
+ */
+template <int DOF>
+void convertJointWaypoint(const FixedJointWaypoint<DOF> &fixed_joint_way_point, JointWaypoint *joint_way_point)
+{
+  if (joint_way_point->size() != DOF)
+    joint_way_point->resize(DOF);
+  for (int index = 0; index < DOF; index++)
+  {
+    (*joint_way_point)[index].position = fixed_joint_way_point.position(index);
+    (*joint_way_point)[index].velocity = fixed_joint_way_point.velocity(index);
+    (*joint_way_point)[index].acceleration = fixed_joint_way_point.acceleration(index);
+    (*joint_way_point)[index].effort = fixed_joint_way_point.effort(index);
+  }
+}
+
+
+/*****************************************************************************
+** Joint Trajectory
+*****************************************************************************/
+template <int DOF>
+class FixedJointTrajectory
+{
+private:
+  double move_time_;
+  Eigen::Matrix<double, 6, DOF> minimum_jerk_coefficient_;
+
+public:
+  FixedJointTrajectory() : move_time_(0.0), minimum_jerk_coefficient_(Eigen::Matrix<double, 6, DOF>::Zero()) {}
+
+  /**
+   * @brief makeJointTrajectory same quintic as JointTrajectory::makeJointTrajectory, solved in double
+   * @param move_time
+   * @param start
+   * @param goal
+   */
+  bool makeJointTrajectory(double move_time, const FixedJointWaypoint<DOF> &start, const FixedJointWaypoint<DOF> &goal)
+  {
+    if (move_time <= 0.0)
+    {
+      log::error("[FixedJointTrajectory] Move time should be positive.");
+      return false;
+    }
+    move_time_ = move_time;
+
+    Eigen::Matrix<double, 3, DOF> start_boundary;
+    Eigen::Matrix<double, 3, DOF> goal_boundary;
+    start_boundary << start.position.transpose(), start.velocity.transpose(), start.acceleration.transpose();
+    goal_boundary << goal.position.transpose(), goal.velocity.transpose(), goal.acceleration.transpose();
+    BasicMinimumJerk<double>::solveCoefficient(start_boundary, goal_boundary, move_time, &minimum_jerk_coefficient_);
+    return true;
+  }
+
+  double getMoveTime() const
+  {
+    return move_time_;
+  }
+
+  const Eigen::Matrix<double, 6, DOF> &getMinimumJerkCoefficient() const
+  {
+    return minimum_jerk_coefficient_;
+  }
+
+  /**
+   * @brief getJointWaypoint
+   * @param tick
+   * @param joint_way_point effort is set to zero
+   */
+  void getJointWaypoint(double tick, FixedJointWaypoint<DOF> *joint_way_point) const
+  {
+    const Eigen::Matrix<double, 6, DOF> &c = minimum_jerk_coefficient_;
+    joint_way_point->position = (c.row(0) + tick * (c.row(1) + tick * (c.row(2) + tick * (c.row(3) + tick * (c.row(4) + tick * c.row(5)))))).transpose();
+    joint_way_point->velocity = (c.row(1) + tick * (2.0 * c.row(2) + tick * (3.0 * c.row(3) + tick * (4.0 * c.row(4) + tick * 5.0 * c.row(5))))).transpose();
+    joint_way_point->acceleration = (2.0 * c.row(2) + tick * (6.0 * c.row(3) + tick * (12.0 * c.row(4) + tick * 20.0 * c.row(5)))).transpose();
+    joint_way_point->effort.setZero();
+  }
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+
+/*****************************************************************************
+** Kinematics
+*****************************************************************************/
+namespace math
+{
+/**
+ * @brief fixedPoseDifference same as poseDifference with a fixed-size result
+ */
+inline Vector6d fixedPoseDifference(const Eigen::Vector3d &desired_position, const Eigen::Vector3d &present_position,
+                                    const Eigen::Matrix3d &desired_orientation, const Eigen::Matrix3d &present_orientation)
+{
+  Vector6d pose_difference;
+  pose_difference.head<3>() = positionDifference(desired_position, present_position);
+  pose_difference.tail<3>() = orientationDifference(desired_orientation, present_orientation);
+  return pose_difference;
+}
+
+/**
+ * @brief fixedJacobian geometric jacobian of revolute active joints from the component poses of the manipulator,
+ *        solve forward kinematics before calling it
+ * @param manipulator
+ * @param tool_name
+ * @param jacobian one column per active joint in the order of the joint waypoints, zero for the joints that do not move the tool
+ * @return false if the manipulator does not have DOF active joints or there is no such tool
+ */
+template <int DOF>
+bool fixedJacobian(Manipulator *manipulator, Name tool_name, Eigen::Matrix<double, 6, DOF> *jacobian)
+{
+  const std::shared_ptr<const ManipulatorModel> model = manipulator->getModel();
+  if (model->passive_joint_begin != DOF)
+  {
+    log::error("[fixedJacobian] Wrong DOF.");
+    return false;
+  }
+  std::map<Name, uint8_t>::const_iterator tool = model->component_index.find(tool_name);
+  if (tool == model->component_index.end())
+  {
+    log::error("[fixedJacobian] Wrong tool name.");
+    return false;
+  }
+
+  // Only the active joints between the world and the tool move it
+  jacobian->setZero();
+  const Eigen::Vector3d &tool_position = manipulator->getComponentStateUsingIndex(tool->second).pose_from_world.kinematic.position;
+  int16_t index = tool->second;
+  for (uint8_t depth = 0; index >= 0 && depth < model->component.size(); depth++, index = model->parent_index[index])
+  {
+    if (index >= DOF)
+      continue;
+    const KinematicPose &joint_pose = manipulator->getComponentStateUsingIndex(index).pose_from_world.kinematic;
+    const Eigen::Vector3d axis = joint_pose.orientation * model->component[index].joint_constant.axis;
+    jacobian->template block<3, 1>(0, index) = axis.cross(tool_position - joint_pose.position);
+    jacobian->template block<3, 1>(3, index) = axis;
+  }
+  return true;
+}
+} // namespace math
+
+} // namespace robotis_manipulator
+
+#endif // ROBOTIS_MANIPULATOR_FIXED_H_
@@ -0,0 +1,451 @@
+/*******************************************************************************
+* Copyright 2018 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/* Authors: Darby Lim, Hye-Jong KIM, Ryan Shim, Yong-Ho Na */
+
+#ifndef ROBOTIS_MANIPULATOR_KINEMATICS_H_
+#define ROBOTIS_MANIPULATOR_KINEMATICS_H_
+
+// Reference Kinematics implementations for manipulators built with addWorld, addJoint and addTool.
+
+#if defined(__OPENCR__)
+  #include <Eigen.h>  // Calls main Eigen matrix class library
+  #include <Eigen/LU> // Calls inverse, determinant, LU decomp., etc.
+  #include <Eigen/QR>
+  #include <Eigen/Cholesky>
+#else
+  #include <eigen3/Eigen/Eigen>
+  #include <eigen3/Eigen/LU>
+  #include <eigen3/Eigen/QR>
+  #include <eigen3/Eigen/Cholesky>
+#endif
+
+#include <list>
+#include <unordered_map>
+
+#if !defined(__OPENCR__)
+  #include <condition_variable>
+  #include <functional>
+  #include <memory>
+  #include <mutex>
+  #include <thread>
+#endif
+
+#include "robotis_manipulator_common.h"
+#include "robotis_manipulator_manager.h"
+#include "robotis_manipulator_math.h"
+
+namespace robotis_manipulator
+{
+
+/*****************************************************************************
+** Product of Exponentials Kinematics
+*****************************************************************************/
+/**
+ * @brief PoEKinematics forward kinematics of revolute joints from the relative pose and the axis of each component.
+ *        A component pose is the parent pose, times the relative pose from the parent, times the rotation
+ *        about the joint axis by the joint position. Tools do not rotate.
+ *        Only the subtrees below a changed joint position or pose are recomputed.
+ *        The solver keeps a cache of the manipulator model, use one instance per thread.
+ */
+class PoEKinematics : public Kinematics
+{
+private:
+  std::shared_ptr<const ManipulatorModel> model_;
+  std::vector<uint8_t> traversal_order_;    // component slots, every parent before its children
+  std::vector<uint8_t> outdated_;           // per slot, set while solving when the slot or one of its parents changed
+
+  Eigen::MatrixXd jacobian_;
+  Eigen::VectorXd pose_difference_;
+  Eigen::VectorXd delta_position_;
+
+  void fillJacobian(Manipulator *manipulator, int16_t tool_index, Eigen::MatrixXd *jacobian);
+
+protected:
+  /**
+   * @brief solveChain forward kinematics of the outdated components, and the jacobian of a tool if jacobian is not nullptr.
+   *        The manipulator is marked solved afterwards.
+   * @param manipulator
+   * @param tool_index component slot from findToolIndex()
+   * @param jacobian same layout as jacobian(), keeps its storage if the size does not change
+   */
+  void solveChain(Manipulator *manipulator, int16_t tool_index, Eigen::MatrixXd *jacobian);
+  /**
+   * @brief updateModel rebuilds the traversal order when the model revision of the manipulator changed
+   * @param manipulator
+   * @return current model of the manipulator
+   */
+  const ManipulatorModel &updateModel(Manipulator *manipulator);
+  /**
+   * @brief findToolIndex
+   * @param manipulator
+   * @param tool_name
+   * @return component slot of the tool, -1 if there is no such component
+   */
+  int16_t findToolIndex(Manipulator *manipulator, Name tool_name);
+
+public:
+  PoEKinematics() {}
+  virtual ~PoEKinematics() {}
+
+  virtual void setOption(const void *arg);
+  /**
+   * @brief jacobian geometric jacobian of tool_name, one column per active joint in the order of
+   *        getAllActiveJointComponentName(), zero for the joints that do not move the tool
+   * @param manipulator forward kinematics is updated first if needed
+   * @param tool_name
+   */
+  virtual Eigen::MatrixXd jacobian(Manipulator *manipulator, Name tool_name);
+  virtual void solveForwardKinematics(Manipulator *manipulator);
+  /**
+   * @brief isPositionOnly true, only the kinematic poses are solved. Override it to return false
+   *        when a derived solver fills the dynamic poses as well.
+   */
+  virtual bool isPositionOnly() const { return true; }
+  /**
+   * @brief solveInverseKinematics Newton-Raphson on the jacobian, starting from the joint positions of the manipulator
+   */
+  virtual bool solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue>* goal_joint_position);
+
+  /**
+   * @brief solveForwardKinematicsAndJacobian solves forward kinematics and computes the jacobian of tool_name in the same pass
+   * @param manipulator
+   * @param tool_name
+   * @param jacobian same layout as jacobian()
+   * @return false if there is no such tool
+   */
+  bool solveForwardKinematicsAndJacobian(Manipulator *manipulator, Name tool_name, Eigen::MatrixXd *jacobian);
+};
+
+
+/*****************************************************************************
+** Damped Least Squares Kinematics
+*****************************************************************************/
+typedef struct _DampedLeastSquaresOption
+{
+  uint8_t iteration;                  // iteration budget of a solve
+  double position_tolerance;          // [m]
+  double orientation_tolerance;       // [rad]
+  double step_tolerance;              // [rad], stop when the joints do not move any more
+  double max_damping;                 // damping at a singularity
+  double manipulability_threshold;    // no damping above it
+} DampedLeastSquaresOption;
+
+/**
+ * @brief DampedLeastSquaresKinematics PoEKinematics with a damped least squares inverse kinematics.
+ *        The damping grows as the manipulability sqrt(det(J^T J)) drops below the threshold, so the
+ *        solver stays bounded near singularities and is an undamped Gauss-Newton step elsewhere.
+ *        A solve starts from the joint positions of the manipulator, e.g. the previous tick of Trajectory,
+ *        and stops as soon as both tolerances are met. The workspaces are kept between solves, so a solve
+ *        does not allocate once the solver has seen the manipulator.
+ */
+class DampedLeastSquaresKinematics : public PoEKinematics
+{
+private:
+  DampedLeastSquaresOption option_;
+  uint8_t last_iteration_;
+
+  Manipulator goal_manipulator_;
+  Eigen::MatrixXd jacobian_;
+  Eigen::MatrixXd normal_matrix_;
+  Eigen::LDLT<Eigen::MatrixXd> normal_decomposition_;
+  Eigen::VectorXd gradient_;
+  Eigen::VectorXd delta_position_;
+
+public:
+  DampedLeastSquaresKinematics();
+  virtual ~DampedLeastSquaresKinematics() {}
+
+  /**
+   * @brief setOption
+   * @param arg const DampedLeastSquaresOption *
+   */
+  virtual void setOption(const void *arg);
+  virtual bool solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue>* goal_joint_position);
+
+  const DampedLeastSquaresOption &getOption() const;
+  /**
+   * @brief getLastIteration
+   * @return iterations used by the last solveInverseKinematics()
+   */
+  uint8_t getLastIteration() const;
+};
+
+
+/*****************************************************************************
+** Analytic Kinematics
+*****************************************************************************/
+typedef enum _AnalyticGeometry
+{
+  AUTO_GEOMETRY = 0,            // detected from the manipulator
+  ITERATIVE_GEOMETRY,           // always DampedLeastSquaresKinematics
+  PLANAR_WRIST_GEOMETRY,        // 4 DOF: base yaw, then three parallel pitch joints, e.g. OpenManipulator-X
+  SPHERICAL_WRIST_GEOMETRY      // 6 DOF: base yaw, two parallel pitch joints, then three joints with intersecting axes
+} AnalyticGeometry;
+
+typedef struct _AnalyticKinematicsOption
+{
+  AnalyticGeometry geometry;
+  DampedLeastSquaresOption iterative;   // fallback and verification tolerances
+} AnalyticKinematicsOption;
+
+/**
+ * @brief AnalyticKinematics closed-form inverse kinematics of the planar wrist and spherical wrist arms.
+ *        Both need the base joint to be the only one below the world and every link of the arm to lie in the
+ *        plane of the pitch joints. The geometry is detected from the zero configuration of the manipulator,
+ *        once per model revision and tool, relative to the world pose so that moving the base keeps it valid.
+ *        Every branch is computed (4 for the planar wrist, 8 for the spherical wrist), an angle outside its joint
+ *        limit being turned by 2 pi when that brings it inside. The branches within the joint limits come first, each group closest to the joint positions of the manipulator first, and the first one that
+ *        passes a forward kinematics check is returned. Other geometries, unreachable targets and targets that no
+ *        branch reaches fall back to DampedLeastSquaresKinematics.
+ */
+class AnalyticKinematics : public DampedLeastSquaresKinematics
+{
+private:
+  AnalyticKinematicsOption analytic_option_;
+
+  // Geometry of the detected tool relative to the world pose, base frame x forward, y pitch axis, z base axis
+  AnalyticGeometry geometry_;
+  uint32_t geometry_revision_;
+  int16_t geometry_tool_index_;
+  uint8_t joint_slot_[6];                       // component slot of each joint from the base to the tool
+  Eigen::Vector3d base_position_;
+  Eigen::Matrix3d base_frame_;                  // columns x, y, z
+  Eigen::Vector2d shoulder_;                    // planar (x, z) position of the first pitch joint
+  double link_length_[3];
+  double link_angle_[3];                        // planar angle of each link at the zero configuration
+  double pitch_sign_[3];                        // +1 if the pitch axis is y, -1 if it is -y
+  Eigen::Matrix3d wrist_axis_;                  // columns: world axes of the wrist joints at the zero configuration
+  Eigen::Vector3d wrist_offset_;                // from the wrist center to the tool at the zero configuration
+  Eigen::Matrix3d tool_orientation_;            // tool orientation at the zero configuration
+
+  Eigen::Matrix<double, 6, 8> branch_;
+  Manipulator check_manipulator_;
+
+  bool updateGeometry(Manipulator *manipulator, int16_t tool_index);
+  bool setPlanarGeometry(const Eigen::Vector3d *position, const Eigen::Vector3d *axis, uint8_t pitch_size, const Eigen::Vector3d &end);
+  uint8_t solveBranch(Manipulator *manipulator, const Pose &target_pose);
+  bool checkBranch(int16_t tool_index, const Pose &target_pose, uint8_t branch);      // on check_manipulator_
+
+public:
+  AnalyticKinematics();
+  virtual ~AnalyticKinematics() {}
+
+  /**
+   * @brief setOption
+   * @param arg const AnalyticKinematicsOption *
+   */
+  virtual void setOption(const void *arg);
+  virtual bool solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue>* goal_joint_position);
+
+  /**
+   * @brief solveAllInverseKinematics every branch that reaches the target, closest to the joint positions of
+   *        the manipulator first, joint limits not checked
+   * @param manipulator
+   * @param tool_name
+   * @param target_pose
+   * @param goal_joint_position
+   * @return number of branches, 0 if the geometry is not analytic or the target is out of reach
+   */
+  uint8_t solveAllInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointWaypoint> *goal_joint_position);
+  /**
+   * @brief getGeometry
+   * @return geometry used for tool_name, ITERATIVE_GEOMETRY if it is not analytic
+   */
+  AnalyticGeometry getGeometry(Manipulator *manipulator, Name tool_name);
+};
+
+
+/*****************************************************************************
+** Cached Kinematics
+*****************************************************************************/
+typedef struct _KinematicsCacheOption
+{
+  uint16_t capacity;                  // solutions kept, the least recently used is dropped first
+  double position_resolution;         // [m] quantization of the target and world positions
+  double orientation_resolution;      // quantization of the entries of the target and world rotation matrices
+  double seed_resolution;             // [rad] quantization of the joint positions the solve starts from
+  double position_tolerance;          // [m] forward kinematics check before a solution is stored
+  double orientation_tolerance;       // [rad]
+} KinematicsCacheOption;
+
+/**
+ * @brief CachedKinematics least recently used cache of inverse kinematics solutions in front of another Kinematics,
+ *        e.g. for pick and place cycles that solve the same poses again and again. A solution is keyed by the tool
+ *        name, the quantized target pose, the quantized world pose and the quantized joint positions the solve starts
+ *        from, and is only stored after a forward kinematics check. The cache is cleared when the model revision of
+ *        the manipulator or the option of the solver changes. Everything else is forwarded to the solver, which is
+ *        not owned.
+ */
+class CachedKinematics : public Kinematics
+{
+private:
+  typedef struct _Key
+  {
+    Name tool_name;
+    std::vector<int64_t> cell;
+
+    bool operator==(const _Key &key) const
+    {
+      return tool_name == key.tool_name && cell == key.cell;
+    }
+  } Key;
+
+  struct KeyHash
+  {
+    size_t operator()(const Key &key) const;
+  };
+
+  typedef struct _Entry
+  {
+    Key key;
+    std::vector<double> joint_position;
+  } Entry;
+
+  Kinematics *kinematics_;
+  KinematicsCacheOption option_;
+  uint32_t revision_;
+
+  std::list<Entry> entry_;                                                  // most recently used first
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+  Key key_;
+  Manipulator check_manipulator_;
+
+  uint32_t hit_count_;
+  uint32_t miss_count_;
+
+  void makeKey(Manipulator *manipulator, Name tool_name, const Pose &target_pose);
+  bool checkSolution(Manipulator *manipulator, Name tool_name, const Pose &target_pose, const std::vector<JointValue> &goal_joint_position);
+
+public:
+  /**
+   * @brief CachedKinematics
+   * @param kinematics solver behind the cache, owned by the caller
+   */
+  CachedKinematics(Kinematics *kinematics);
+  virtual ~CachedKinematics() {}
+
+  virtual void setOption(const void *arg);
+  virtual Eigen::MatrixXd jacobian(Manipulator *manipulator, Name tool_name);
+  virtual void solveForwardKinematics(Manipulator *manipulator);
+  virtual bool isPositionOnly() const;
+  /**
+   * @brief solveInverseKinematics cached solution if there is one, the solver otherwise. The velocity, acceleration and
+   *        effort of a cached solution are the ones of the manipulator.
+   */
+  virtual bool solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue>* goal_joint_position);
+
+  /**
+   * @brief setCacheOption clears the cache
+   * @param option
+   */
+  void setCacheOption(const KinematicsCacheOption &option);
+  const KinematicsCacheOption &getCacheOption() const;
+  void clearCache();
+  size_t getCacheSize() const;
+  uint32_t getHitCount() const;
+  uint32_t getMissCount() const;
+};
+
+
+#if !defined(__OPENCR__)
+/*****************************************************************************
+** Batch Inverse Kinematics
+*****************************************************************************/
+typedef struct _InverseKinematicsResult
+{
+  bool solved;
+  std::vector<JointValue> goal_joint_position;
+} InverseKinematicsResult;
+
+/**
+ * @brief BatchKinematics solves many inverse kinematics targets of one tool on a pool of threads, e.g. for
+ *        reachability checks. Every thread has its own solver from the factory, and every target is solved
+ *        on a fresh copy of the given manipulator, so a result does not depend on the thread that solved it
+ *        or on the targets solved before it. The targets are split evenly between the threads,
+ *        a thread that runs out of targets steals half of the remaining ones of another thread.
+ *        The calling thread takes part in the solve. One batch at a time. Not available on OpenCR.
+ */
+class BatchKinematics
+{
+public:
+  typedef std::function<Kinematics *()> KinematicsFactory;    // new solver, deleted by BatchKinematics
+
+private:
+  typedef struct _Worker
+  {
+    std::unique_ptr<Kinematics> kinematics;
+    Manipulator manipulator;
+    std::mutex mutex;                 // guards begin and end
+    size_t begin;                     // remaining targets [begin, end)
+    size_t end;
+    std::thread thread;
+  } Worker;
+
+  std::vector<std::unique_ptr<Worker>> worker_;
+
+  std::mutex mutex_;
+  std::condition_variable start_condition_;
+  std::condition_variable done_condition_;
+  uint32_t batch_;
+  uint8_t running_size_;
+  bool stop_;
+
+  // Present batch
+  const Manipulator *manipulator_;
+  Name tool_name_;
+  const Pose *target_pose_;
+  std::vector<InverseKinematicsResult> *result_;
+
+  void run(uint8_t thread);
+  void solveBatch(uint8_t thread);
+  bool takeTarget(uint8_t thread, size_t *target);
+
+public:
+  /**
+   * @brief BatchKinematics starts thread_size - 1 threads
+   * @param factory called once per thread
+   * @param thread_size 0 for the number of cores
+   */
+  BatchKinematics(KinematicsFactory factory, uint8_t thread_size = 0);
+  ~BatchKinematics();
+
+  /**
+   * @brief setOption setOption() of the solver of every thread
+   * @param arg
+   */
+  void setOption(const void *arg);
+  /**
+   * @brief solveInverseKinematics
+   * @param manipulator model and starting joint positions, not modified
+   * @param tool_name
+   * @param target_pose
+   * @param target_size
+   * @param result one per target, in the order of the targets
+   * @return true if every target is solved
+   */
+  bool solveInverseKinematics(const Manipulator &manipulator, Name tool_name, const Pose *target_pose, size_t target_size,
+                              std::vector<InverseKinematicsResult> *result);
+  bool solveInverseKinematics(const Manipulator &manipulator, Name tool_name, const std::vector<Pose> &target_pose,
+                              std::vector<InverseKinematicsResult> *result);
+
+  uint8_t getThreadSize() const;
+};
+#endif
+
+} // namespace robotis_manipulator
+
+#endif // ROBOTIS_MANIPULATOR_KINEMATICS_H_
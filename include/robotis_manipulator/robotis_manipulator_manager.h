@@ -40,6 +40,26 @@ public:
   virtual Eigen::MatrixXd jacobian(Manipulator *manipulator, Name tool_name) = 0;
   virtual void solveForwardKinematics(Manipulator *manipulator) = 0;                                                                                   //Every joint value to every component pose
   virtual bool solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue>* goal_joint_position) = 0;    //An component pose to every joint value
+
+  /**
+   * @brief isPositionOnly
+   * @return true if solveForwardKinematics() reads nothing but the joint positions, the chain and the component poses,
+   *         false (default) if it also reads e.g. the joint velocities to fill the dynamic poses
+   */
+  virtual bool isPositionOnly() const { return false; }
+
+  /**
+   * @brief updateForwardKinematics for a position only solver, solves forward kinematics only if a joint position,
+   *        the chain or a pose changed since the last update of this manipulator. Other solvers always solve.
+   * @param manipulator
+   */
+  void updateForwardKinematics(Manipulator *manipulator)
+  {
+    if (isPositionOnly() && manipulator->isForwardKinematicsSolved())
+      return;
+    solveForwardKinematics(manipulator);
+    manipulator->markForwardKinematicsSolved();
+  }
 };
 
 class Dynamics
@@ -109,6 +129,36 @@ public:
   virtual void makeJointTrajectory(double move_time, JointWaypoint start, const void *arg) = 0; 
   virtual void setOption(const void *arg) = 0;
   virtual JointWaypoint getJointWaypoint(double tick) = 0;
+
+  /**
+   * @brief sampleJointWaypoint override to evaluate many ticks at once, the default calls getJointWaypoint per tick
+   * @param tick
+   * @param position one row per tick, one column per joint
+   * @param velocity nullptr to skip
+   * @param acceleration nullptr to skip
+   */
+  virtual void sampleJointWaypoint(const Eigen::Ref<const Eigen::VectorXd> &tick,
+                                   Eigen::MatrixXd *position,
+                                   Eigen::MatrixXd *velocity = nullptr,
+                                   Eigen::MatrixXd *acceleration = nullptr)
+  {
+    for (Eigen::Index sample = 0; sample < tick.size(); sample++)
+    {
+      JointWaypoint joint_way_point = getJointWaypoint(tick(sample));
+      if (sample == 0)
+      {
+        if (position != nullptr) position->resize(tick.size(), joint_way_point.size());
+        if (velocity != nullptr) velocity->resize(tick.size(), joint_way_point.size());
+        if (acceleration != nullptr) acceleration->resize(tick.size(), joint_way_point.size());
+      }
+      for (uint32_t index = 0; index < joint_way_point.size(); index++)
+      {
+        if (position != nullptr) (*position)(sample, index) = joint_way_point.at(index).position;
+        if (velocity != nullptr) (*velocity)(sample, index) = joint_way_point.at(index).velocity;
+        if (acceleration != nullptr) (*acceleration)(sample, index) = joint_way_point.at(index).acceleration;
+      }
+    }
+  }
 };
 
 class CustomTaskTrajectory
@@ -120,6 +170,18 @@ public:
   virtual void makeTaskTrajectory(double move_time, TaskWaypoint start, const void *arg) = 0; 
   virtual void setOption(const void *arg) = 0;
   virtual TaskWaypoint getTaskWaypoint(double tick) = 0;
+
+  /**
+   * @brief sampleTaskWaypoint override to evaluate many ticks at once, the default calls getTaskWaypoint per tick
+   * @param tick
+   * @param task_way_point one waypoint per tick
+   */
+  virtual void sampleTaskWaypoint(const Eigen::Ref<const Eigen::VectorXd> &tick, std::vector<TaskWaypoint> *task_way_point)
+  {
+    task_way_point->resize(tick.size());
+    for (Eigen::Index sample = 0; sample < tick.size(); sample++)
+      task_way_point->at(sample) = getTaskWaypoint(tick(sample));
+  }
 };
 
 } // namespace ROBOTIS_MANIPULATOR
@@ -97,6 +97,48 @@ Eigen::VectorXd poseDifference(Eigen::Vector3d desired_position, Eigen::Vector3d
 Eigen::VectorXd dynamicPoseDifference(Eigen::Vector3d desired_linear_velocity, Eigen::Vector3d present_linear_velocity,
                                       Eigen::Vector3d desired_angular_velocity, Eigen::Vector3d present_angular_velocity);
 
+
+/*****************************************************************************
+** Scalar Templates
+*****************************************************************************/
+// Same math on a chosen scalar type, instantiated for float and double.
+// Scalar arguments are not deduced, call e.g. convertRPYToRotationMatrix<float>(roll, pitch, yaw).
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> convertRollAngleToRotationMatrix(typename Eigen::NumTraits<Scalar>::Real angle);
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> convertPitchAngleToRotationMatrix(typename Eigen::NumTraits<Scalar>::Real angle);
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> convertYawAngleToRotationMatrix(typename Eigen::NumTraits<Scalar>::Real angle);
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> convertRotationMatrixToRPYVector(const Eigen::Matrix<Scalar, 3, 3>& rotation_matrix);
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> convertRPYToRotationMatrix(typename Eigen::NumTraits<Scalar>::Real roll,
+                                                       typename Eigen::NumTraits<Scalar>::Real pitch,
+                                                       typename Eigen::NumTraits<Scalar>::Real yaw);
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> convertOmegaToRPYVelocity(const Eigen::Matrix<Scalar, 3, 1>& rpy_vector, const Eigen::Matrix<Scalar, 3, 1>& omega);
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> convertRPYVelocityToOmega(const Eigen::Matrix<Scalar, 3, 1>& rpy_vector, const Eigen::Matrix<Scalar, 3, 1>& rpy_velocity);
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> convertOmegaDotToRPYAcceleration(const Eigen::Matrix<Scalar, 3, 1>& rpy_vector, const Eigen::Matrix<Scalar, 3, 1>& rpy_velocity,
+                                                             const Eigen::Matrix<Scalar, 3, 1>& omega_dot);
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> convertRPYAccelerationToOmegaDot(const Eigen::Matrix<Scalar, 3, 1>& rpy_vector, const Eigen::Matrix<Scalar, 3, 1>& rpy_velocity,
+                                                             const Eigen::Matrix<Scalar, 3, 1>& rpy_acceleration);
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> matrixLogarithm(const Eigen::Matrix<Scalar, 3, 3>& rotation_matrix);
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> skewSymmetricMatrix(const Eigen::Matrix<Scalar, 3, 1>& v);
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> rodriguesRotationMatrix(const Eigen::Matrix<Scalar, 3, 1>& axis, typename Eigen::NumTraits<Scalar>::Real angle);
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> positionDifference(const Eigen::Matrix<Scalar, 3, 1>& desired_position, const Eigen::Matrix<Scalar, 3, 1>& present_position);
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> orientationDifference(const Eigen::Matrix<Scalar, 3, 3>& desired_orientation, const Eigen::Matrix<Scalar, 3, 3>& present_orientation);
+
 } // math
 } // namespace robotis_manipulator
 
@@ -20,7 +20,9 @@
 #define ROBOTIS_MNAMIPULATOR_TRAJECTORY_GENERATOR_H_
 
 #include <math.h>
+#include <atomic>
 #include <vector>
+#include <algorithm>
 
 #include "robotis_manipulator_manager.h"
 
@@ -38,32 +40,92 @@
 
 namespace robotis_manipulator
 {
-class MinimumJerk
+/*****************************************************************************
+** Scalar type of the minimum jerk trajectories
+*****************************************************************************/
+// Coefficients and evaluation run on this type, the interface stays double.
+// Define ROBOTIS_MANIPULATOR_FLOAT_TRAJECTORY to build them in single precision,
+// e.g. on targets without a double precision FPU.
+#if defined(ROBOTIS_MANIPULATOR_FLOAT_TRAJECTORY)
+typedef float TrajectoryScalar;
+#else
+typedef double TrajectoryScalar;
+#endif
+
+template <typename Scalar>
+class BasicMinimumJerk
 {
+public:
+  typedef Eigen::Matrix<Scalar, 6, Eigen::Dynamic> Coefficient;   // one fixed-size column per axis
+
 private:
-  Eigen::VectorXd coefficient_;
+  Eigen::Matrix<Scalar, Eigen::Dynamic, 1> coefficient_;
 
 public:
-  MinimumJerk();
-  virtual ~MinimumJerk();
+  BasicMinimumJerk();
+  virtual ~BasicMinimumJerk();
+
+  /**
+   * @brief calcInverseMatrix inverse of the boundary matrix of the quintic, zero if move_time is not positive
+   * @param move_time
+   */
+  static Eigen::Matrix<Scalar, 3, 3> calcInverseMatrix(Scalar move_time);
+  /**
+   * @brief solveCoefficient the quintic solve behind every calcCoefficient, also used by the fixed-DOF path
+   * @param start position, velocity and acceleration rows in double, one column per axis
+   * @param goal same layout as start
+   * @param move_time
+   * @param coefficient six rows, one column per axis, sized by the caller
+   */
+  template <typename Boundary, typename Coefficient>
+  static void solveCoefficient(const Eigen::MatrixBase<Boundary> &start,
+                               const Eigen::MatrixBase<Boundary> &goal,
+                               double move_time,
+                               Eigen::MatrixBase<Coefficient> *coefficient)
+  {
+    const Scalar T = move_time;
+    Eigen::Matrix<Scalar, 3, Boundary::ColsAtCompileTime> b(3, start.cols());
+    b.row(0) = (goal.row(0) - start.row(0)).template cast<Scalar>()
+             - (start.row(1).template cast<Scalar>() * T + Scalar(0.5) * start.row(2).template cast<Scalar>() * T * T);
+    b.row(1) = (goal.row(1) - start.row(1)).template cast<Scalar>() - start.row(2).template cast<Scalar>() * T;
+    b.row(2) = (goal.row(2) - start.row(2)).template cast<Scalar>();
+
+    coefficient->row(0) = start.row(0).template cast<Scalar>();
+    coefficient->row(1) = start.row(1).template cast<Scalar>();
+    coefficient->row(2) = (0.5 * start.row(2)).template cast<Scalar>();
+    coefficient->template bottomRows<3>().noalias() = calcInverseMatrix(T) * b;
+  }
 
   void calcCoefficient(Point start,
                        Point goal,
                        double move_time);
+  /**
+   * @brief calcCoefficient
+   * @param start
+   * @param goal
+   * @param move_time
+   * @param coefficient one column per axis, all solved with the same move_time
+   */
+  void calcCoefficient(const std::vector<Point> &start,
+                       const std::vector<Point> &goal,
+                       double move_time,
+                       Coefficient *coefficient);
 
   Eigen::VectorXd getCoefficient();
 };
 
-class JointTrajectory
+template <typename Scalar>
+class BasicJointTrajectory
 {
 private:
   uint8_t coefficient_size_;
-  MinimumJerk minimum_jerk_trajectory_generator_;
-  Eigen::MatrixXd minimum_jerk_coefficient_;
+  double move_time_;
+  BasicMinimumJerk<Scalar> minimum_jerk_trajectory_generator_;
+  typename BasicMinimumJerk<Scalar>::Coefficient minimum_jerk_coefficient_;
 
 public:
-  JointTrajectory();
-  virtual ~JointTrajectory();
+  BasicJointTrajectory();
+  virtual ~BasicJointTrajectory();
 
   /**
    * @brief makeJointTrajectory
@@ -76,19 +138,65 @@ public:
             JointWaypoint goal
             );
   Eigen::MatrixXd getMinimumJerkCoefficient();
+  uint8_t getSize() const;
+  double getMoveTime() const;
+  /**
+   * @brief getJointExtremum exact range of position and velocity of one joint over the whole move
+   * @param index joint index
+   * @param position
+   * @param velocity
+   */
+  void getJointExtremum(uint8_t index, Limit *position, Limit *velocity) const;
   JointWaypoint getJointWaypoint(double tick);
+  /**
+   * @brief getJointWaypoint
+   * @param tick
+   * @param joint_way_point caller-owned buffer, only resized when the number of joints changes
+   */
+  void getJointWaypoint(double tick, JointWaypoint *joint_way_point) const;
+  /**
+   * @brief sampleJointWaypoint evaluates many ticks at once without changing any state
+   * @param tick
+   * @param position one row per tick, one column per joint, only resized when the size changes
+   * @param velocity same layout, nullptr to skip
+   * @param acceleration same layout, nullptr to skip
+   */
+  void sampleJointWaypoint(const Eigen::Ref<const Eigen::VectorXd> &tick,
+                           Eigen::MatrixXd *position,
+                           Eigen::MatrixXd *velocity = nullptr,
+                           Eigen::MatrixXd *acceleration = nullptr) const;
 };
 
-class TaskTrajectory
+template <typename Scalar>
+class BasicTaskTrajectory
 {
 private:
+  typedef Eigen::Matrix<Scalar, 3, 1> Vector3;
+  typedef Eigen::Matrix<Scalar, 3, 6> AxisState;   // position, velocity and acceleration rows, one column per axis
+
   uint8_t coefficient_size_;
-  MinimumJerk minimum_jerk_trajectory_generator_;
-  Eigen::MatrixXd minimum_jerk_coefficient_;
+  BasicMinimumJerk<Scalar> minimum_jerk_trajectory_generator_;
+  typename BasicMinimumJerk<Scalar>::Coefficient minimum_jerk_coefficient_;
+
+  OrientationInterpolation orientation_interpolation_;
+  Eigen::Quaternion<Scalar> start_orientation_;      // SLERP_INTERPOLATION only
+  Eigen::Quaternion<Scalar> goal_orientation_;
+  Vector3 rotation_axis_;                            // in the world frame
+  Scalar rotation_angle_;
+
+  void convertAxisStateToTaskWaypoint(const AxisState &state, TaskWaypoint *task_way_point) const;
 
 public:
-  TaskTrajectory();
-  virtual ~TaskTrajectory();
+  BasicTaskTrajectory();
+  virtual ~BasicTaskTrajectory();
+
+  /**
+   * @brief setOrientationInterpolation
+   * @param orientation_interpolation RPY_INTERPOLATION interpolates roll, pitch and yaw separately,
+   *        SLERP_INTERPOLATION rotates about one fixed axis with a minimum jerk angle
+   */
+  void setOrientationInterpolation(OrientationInterpolation orientation_interpolation);
+  OrientationInterpolation getOrientationInterpolation();
 
   /**
    * @brief makeTaskTrajectory
@@ -102,6 +210,171 @@ public:
             );
   Eigen::MatrixXd getMinimumJerkCoefficient();
   TaskWaypoint getTaskWaypoint(double tick);
+  /**
+   * @brief sampleTaskWaypoint evaluates many ticks at once without changing any state
+   * @param tick
+   * @param task_way_point one waypoint per tick, only resized when the size changes
+   */
+  void sampleTaskWaypoint(const Eigen::Ref<const Eigen::VectorXd> &tick, std::vector<TaskWaypoint> *task_way_point) const;
+};
+
+// Instantiated for float and double in robotis_manipulator_trajectory_generator.cpp
+typedef BasicMinimumJerk<TrajectoryScalar> MinimumJerk;
+typedef BasicJointTrajectory<TrajectoryScalar> JointTrajectory;
+typedef BasicTaskTrajectory<TrajectoryScalar> TaskTrajectory;
+typedef MinimumJerk::Coefficient MinimumJerkCoefficient;
+
+class SCurve
+{
+private:
+  double distance_;
+  double jerk_;
+  double jerk_time_;
+  double acceleration_time_;
+  double constant_velocity_time_;
+  double max_reached_acceleration_;
+  double max_reached_velocity_;
+
+  void getAccelerationPoint(double tick, Point *point) const;
+
+public:
+  SCurve();
+  virtual ~SCurve();
+
+  /**
+   * @brief calcProfile jerk-limited rest-to-rest profile of the shortest time
+   * @param distance
+   * @param max_velocity
+   * @param max_acceleration
+   * @param max_jerk
+   */
+  bool calcProfile(double distance,
+                   double max_velocity,
+                   double max_acceleration,
+                   double max_jerk);
+  double getMoveTime() const;
+  double getMaxVelocity() const;
+  void getPoint(double tick, Point *point) const;
+};
+
+class JointSCurveTrajectory
+{
+private:
+  SCurve s_curve_;                  // normalized profile, 0 to 1
+  JointWaypoint start_;
+  std::vector<double> distance_;
+
+public:
+  JointSCurveTrajectory();
+  virtual ~JointSCurveTrajectory();
+
+  /**
+   * @brief makeJointTrajectory all joints share one normalized profile, limited by the slowest joint
+   * @param start
+   * @param goal
+   * @param max_velocity
+   * @param max_acceleration
+   * @param max_jerk
+   */
+  bool makeJointTrajectory(JointWaypoint start,
+                           JointWaypoint goal,
+                           std::vector<double> max_velocity,
+                           std::vector<double> max_acceleration,
+                           std::vector<double> max_jerk);
+  double getMoveTime() const;
+  uint8_t getSize() const;
+  /**
+   * @brief getJointExtremum exact range of position and velocity of one joint over the whole move
+   * @param index joint index
+   * @param position
+   * @param velocity
+   */
+  void getJointExtremum(uint8_t index, Limit *position, Limit *velocity) const;
+  JointWaypoint getJointWaypoint(double tick);
+  /**
+   * @brief getJointWaypoint
+   * @param tick
+   * @param joint_way_point caller-owned buffer, only resized when the number of joints changes
+   */
+  void getJointWaypoint(double tick, JointWaypoint *joint_way_point) const;
+  /**
+   * @brief sampleJointWaypoint evaluates many ticks at once without changing any state
+   * @param tick
+   * @param position one row per tick, one column per joint, only resized when the size changes
+   * @param velocity same layout, nullptr to skip
+   * @param acceleration same layout, nullptr to skip
+   */
+  void sampleJointWaypoint(const Eigen::Ref<const Eigen::VectorXd> &tick,
+                           Eigen::MatrixXd *position,
+                           Eigen::MatrixXd *velocity = nullptr,
+                           Eigen::MatrixXd *acceleration = nullptr) const;
+};
+
+class TaskPathTrajectory
+{
+private:
+  bool is_line_;
+  double move_time_;
+  double acceleration_time_ratio_;
+  double path_length_;
+  double path_speed_;                   // along the path, during the constant speed phase
+
+  // Line: start_position_ + line_direction_ * s
+  // Helix: center_ + radius_ * (cos(phi) * radial_ + sin(phi) * tangential_) + axis_ * axial_rate_ * phi
+  Eigen::Vector3d start_position_;
+  Eigen::Vector3d line_direction_;
+  Eigen::Vector3d center_;
+  Eigen::Vector3d axis_;
+  Eigen::Vector3d radial_;
+  Eigen::Vector3d tangential_;
+  double radius_;
+  double axial_rate_;                   // axial advance per radian
+  double angle_per_length_;             // signed
+  Eigen::Matrix3d orientation_;
+
+  void getPathPoint(double tick, Point *point) const;
+
+public:
+  TaskPathTrajectory();
+  virtual ~TaskPathTrajectory();
+
+  /**
+   * @brief setAccelerationTimeRatio
+   * @param acceleration_time_ratio share of the move time spent in each of the speed up and slow down phases, up to 0.5
+   */
+  void setAccelerationTimeRatio(double acceleration_time_ratio);
+  /**
+   * @brief makeLineTrajectory straight line at constant speed, orientation is kept
+   * @param move_time
+   * @param start
+   * @param goal_position
+   */
+  bool makeLineTrajectory(double move_time,
+                          TaskWaypoint start,
+                          Eigen::Vector3d goal_position);
+  /**
+   * @brief makeHelixTrajectory circular arc (pitch 0.0) or helix at constant speed, orientation is kept
+   * @param move_time
+   * @param start
+   * @param center any point on the rotation axis
+   * @param axis rotation axis, the angle is positive counterclockwise about it
+   * @param angle
+   * @param pitch advance along the axis per turn
+   */
+  bool makeHelixTrajectory(double move_time,
+                           TaskWaypoint start,
+                           Eigen::Vector3d center,
+                           Eigen::Vector3d axis,
+                           double angle,
+                           double pitch);
+  double getPathLength() const;
+  TaskWaypoint getTaskWaypoint(double tick);
+  /**
+   * @brief getTaskWaypoint
+   * @param tick
+   * @param task_way_point caller-owned buffer
+   */
+  void getTaskWaypoint(double tick, TaskWaypoint *task_way_point) const;
 };
 
 
@@ -113,10 +386,21 @@ class Trajectory
 private:
   TrajectoryType trajectory_type_;
   Time trajectory_time_;
+  double tick_time_;
+  // Speed override, the goal and the ramp rate are written by any thread and taken by the control thread
+  std::atomic<double> speed_override_;
+  std::atomic<double> speed_override_goal_;
+  std::atomic<double> speed_override_ramp_rate_;
+  bool speed_override_applied_;           // a speed other than 1.0 was used since the start time was set
   Manipulator manipulator_;
 
-  JointTrajectory joint_;
-  TaskTrajectory task_;
+  std::vector<JointTrajectory> joint_segment_;
+  std::vector<TaskTrajectory> task_segment_;
+  std::vector<double> segment_start_time_;
+  uint32_t present_segment_index_;
+  OrientationInterpolation orientation_interpolation_;
+  JointSCurveTrajectory joint_s_curve_;
+  TaskPathTrajectory task_path_;
   std::map<Name, CustomJointTrajectory *> cus_joint_;
   std::map<Name, CustomTaskTrajectory *> cus_task_;
 
@@ -124,7 +408,12 @@ private:
   Name present_control_tool_name_;
 
 public:
-  Trajectory() {}
+  Trajectory();
+  /**
+   * @brief Trajectory copies the speed override as it is when the copy is made
+   */
+  Trajectory(const Trajectory &trajectory);
+  Trajectory &operator=(const Trajectory &trajectory);
   ~Trajectory() {}
 
   // Time
@@ -133,18 +422,81 @@ public:
   void setStartTimeToPresentTime();
   void setStartTime(double start_time);
   double getMoveTime();
+  /**
+   * @brief getTickTime trajectory time since the start, advanced at the speed override rate
+   * @return
+   */
   double getTickTime();
 
+  // Speed Override
+  /**
+   * @brief setSpeedOverride safe from another thread, applied at the next setPresentTime()
+   * @param speed_override scale of the trajectory time base, from 0.0 (pause) to 2.0
+   * @param ramp_rate change of the scale per second while moving to the new value, 0.0 to change at once
+   */
+  void setSpeedOverride(double speed_override, double ramp_rate);
+  double getSpeedOverride();
+  void applySpeedOverride(JointWaypoint *joint_way_point);
+
   // Manipulator
-  void setManipulator(Manipulator manipulator);
+  void setManipulator(const Manipulator &manipulator);
   Manipulator* getManipulator();
 
-  // Get Trajectory
-  JointTrajectory getJointTrajectory();
-  TaskTrajectory getTaskTrajectory();
+  // Segment
+  uint32_t getSegmentSize();
+  uint32_t getPresentSegmentIndex();
+  /**
+   * @brief updatePresentSegment
+   * @param tick_time time since the start of the whole trajectory
+   * @return time since the start of the selected segment
+   */
+  double updatePresentSegment(double tick_time);
+
+  /**
+   * @brief getTaskWaypoint of a task, task path or custom task trajectory
+   * @param tick_time time since the start of the whole trajectory
+   * @param task_way_point
+   * @return false if the present trajectory is not a task trajectory
+   */
+  bool getTaskWaypoint(double tick_time, TaskWaypoint *task_way_point);
+
+  // Get Trajectory (present segment)
+  JointTrajectory &getJointTrajectory();
+  TaskTrajectory &getTaskTrajectory();
+  JointSCurveTrajectory &getJointSCurveTrajectory();
+  TaskPathTrajectory &getTaskPathTrajectory();
   CustomJointTrajectory* getCustomJointTrajectory(Name name);
   CustomTaskTrajectory* getCustomTaskTrajectory(Name name);
 
+  /**
+   * @brief getJointExtremum range of position and velocity of each joint over the whole present trajectory
+   * @param position
+   * @param velocity
+   * @return false if the present trajectory is not a built-in joint trajectory
+   */
+  bool getJointExtremum(std::vector<Limit> *position, std::vector<Limit> *velocity) const;
+
+  // Sampling (present trajectory, no state is changed)
+  /**
+   * @brief sampleJointWaypoint
+   * @param tick time since the start of the whole trajectory, in ascending order, clamped to the move time
+   * @param position one row per tick, one column per joint
+   * @param velocity nullptr to skip
+   * @param acceleration nullptr to skip
+   * @return false if the present trajectory is not a joint trajectory
+   */
+  bool sampleJointWaypoint(const Eigen::Ref<const Eigen::VectorXd> &tick,
+                           Eigen::MatrixXd *position,
+                           Eigen::MatrixXd *velocity = nullptr,
+                           Eigen::MatrixXd *acceleration = nullptr) const;
+  /**
+   * @brief sampleTaskWaypoint task trajectory, task path trajectory or custom task trajectory
+   * @param tick time since the start of the whole trajectory, in ascending order, clamped to the move time
+   * @param task_way_point one waypoint per tick
+   * @return false if the present trajectory is not a task trajectory
+   */
+  bool sampleTaskWaypoint(const Eigen::Ref<const Eigen::VectorXd> &tick, std::vector<TaskWaypoint> *task_way_point) const;
+
   // Custom Trajectory Setting
   void addCustomTrajectory(Name trajectory_name, CustomJointTrajectory *custom_trajectory);
   void addCustomTrajectory(Name trajectory_name, CustomTaskTrajectory *custom_trajectory);
@@ -154,7 +506,7 @@ public:
   Name getPresentControlToolName();
 
   // First Waypoint
-  void initTrajectoryWaypoint(Manipulator actual_manipulator, Kinematics *kinematics=nullptr);
+  void initTrajectoryWaypoint(const Manipulator &actual_manipulator, Kinematics *kinematics=nullptr);
 
   // Present Waypoint
   void updatePresentWaypoint(Kinematics* kinematics); //forward kinematics,dynamics
@@ -169,18 +521,68 @@ public:
   // Trajectory
   void setTrajectoryType(TrajectoryType trajectory_type);
   bool checkTrajectoryType(TrajectoryType trajectory_type);
+  void setOrientationInterpolation(OrientationInterpolation orientation_interpolation);
   /**
    * @brief makeJointTrajectory
    * @param start_way_point
    * @param goal_way_point
    */
   bool makeJointTrajectory(JointWaypoint start_way_point, JointWaypoint goal_way_point);
+  /**
+   * @brief makeJointTrajectory
+   * @param start_way_point
+   * @param via_way_point intermediate points followed by the goal point
+   * @param move_time time of each segment, same size as via_way_point
+   */
+  bool makeJointTrajectory(JointWaypoint start_way_point, std::vector<JointWaypoint> via_way_point, std::vector<double> move_time);
+  /**
+   * @brief makeJointSCurveTrajectory move time is computed from the limits
+   * @param start_way_point
+   * @param goal_way_point
+   * @param max_velocity
+   * @param max_acceleration
+   * @param max_jerk
+   */
+  bool makeJointSCurveTrajectory(JointWaypoint start_way_point,
+                                 JointWaypoint goal_way_point,
+                                 std::vector<double> max_velocity,
+                                 std::vector<double> max_acceleration,
+                                 std::vector<double> max_jerk);
   /**
    * @brief makeTaskTrajectory
    * @param start_way_point
    * @param goal_way_point
    */
   bool makeTaskTrajectory(TaskWaypoint start_way_point, TaskWaypoint goal_way_point);
+  /**
+   * @brief makeTaskTrajectory with SLERP_INTERPOLATION the rotation stops at a via point
+   *        unless the segments on both sides turn about the same axis
+   * @param start_way_point
+   * @param via_way_point intermediate points followed by the goal point
+   * @param move_time time of each segment, same size as via_way_point
+   */
+  bool makeTaskTrajectory(TaskWaypoint start_way_point, std::vector<TaskWaypoint> via_way_point, std::vector<double> move_time);
+  /**
+   * @brief makeJointSplineTrajectory one quintic segment between each pair of knots
+   * @param knot_way_point position, velocity and acceleration at each knot
+   * @param knot_time increasing, the move starts at the first knot
+   */
+  bool makeJointSplineTrajectory(std::vector<JointWaypoint> knot_way_point, std::vector<double> knot_time);
+  /**
+   * @brief makeTaskLineTrajectory
+   * @param start_way_point
+   * @param goal_position
+   */
+  bool makeTaskLineTrajectory(TaskWaypoint start_way_point, Eigen::Vector3d goal_position);
+  /**
+   * @brief makeTaskHelixTrajectory
+   * @param start_way_point
+   * @param center
+   * @param axis
+   * @param angle
+   * @param pitch 0.0 for a circular arc
+   */
+  bool makeTaskHelixTrajectory(TaskWaypoint start_way_point, Eigen::Vector3d center, Eigen::Vector3d axis, double angle, double pitch);
   /**
    * @brief makeCustomTrajectory
    * @param trajectory_name
@@ -20,6 +20,65 @@
 
 using namespace robotis_manipulator;
 
+namespace
+{
+// States of the retarget slot
+const uint8_t RETARGET_IDLE = 0;
+const uint8_t RETARGET_WRITING = 1;
+const uint8_t RETARGET_READY = 2;
+const uint8_t RETARGET_READING = 3;
+
+// Maximum rounds of knot insertion while compiling a task trajectory
+const uint8_t TASK_COMPILE_ROUND = 8;
+
+bool isTaskWaypointAtRest(const TaskWaypoint &task_way_point)
+{
+  return task_way_point.dynamic.linear.velocity.norm() < 1e-6 && task_way_point.dynamic.angular.velocity.norm() < 1e-6;
+}
+
+// Velocity and acceleration of every knot from the quadratic through its neighbours,
+// so that quintic segments between the knots join with continuous acceleration.
+// The start knot is the present joint waypoint and keeps its velocity and acceleration.
+void setKnotDerivative(std::vector<JointWaypoint> *knot_way_point, const std::vector<double> &knot_time, bool goal_at_rest)
+{
+  uint32_t knot_size = knot_time.size();
+  uint32_t joint_size = knot_way_point->at(0).size();
+  for(uint32_t knot = 1; knot + 1 < knot_size; knot++)
+  {
+    double h0 = knot_time.at(knot) - knot_time.at(knot - 1);
+    double h1 = knot_time.at(knot + 1) - knot_time.at(knot);
+    for(uint32_t index = 0; index < joint_size; index++)
+    {
+      double d0 = knot_way_point->at(knot).at(index).position - knot_way_point->at(knot - 1).at(index).position;
+      double d1 = knot_way_point->at(knot + 1).at(index).position - knot_way_point->at(knot).at(index).position;
+      knot_way_point->at(knot).at(index).velocity = (h0 * h0 * d1 + h1 * h1 * d0) / (h0 * h1 * (h0 + h1));
+      knot_way_point->at(knot).at(index).acceleration = 2.0 * (h0 * d1 - h1 * d0) / (h0 * h1 * (h0 + h1));
+    }
+  }
+
+  uint32_t last = knot_size - 1;
+  double h_goal = knot_time.at(last) - knot_time.at(last - 1);
+  for(uint32_t index = 0; index < joint_size; index++)
+  {
+    JointValue &goal = knot_way_point->at(last).at(index);
+    const JointValue &before_goal = knot_way_point->at(last - 1).at(index);
+    knot_way_point->at(0).at(index).effort = 0.0;
+    goal.effort = 0.0;
+    if(goal_at_rest)
+    {
+      goal.velocity = 0.0;
+      goal.acceleration = 0.0;
+    }
+    else
+    {
+      double previous_velocity = (knot_size > 2) ? before_goal.velocity : (goal.position - before_goal.position) / h_goal;
+      goal.velocity = 2.0 * (goal.position - before_goal.position) / h_goal - previous_velocity;
+      goal.acceleration = (goal.velocity - previous_velocity) / h_goal;
+    }
+  }
+}
+} // namespace
+
 
 /*****************************************************************************
 ** Constructor and Destructor
@@ -34,6 +93,67 @@ RobotisManipulator::RobotisManipulator()
   trajectory_initialized_state_ = false;
   kinematics_added_state_=false;
   dynamics_added_state_=false;
+  baking_control_period_ = 0.0;
+  baking_option_ = DYNAMICS_ALL_SOVING;
+  trajectory_table_state_ = false;
+  joint_limit_validated_state_ = false;
+  task_compile_state_ = false;
+  task_compile_knot_time_ = 0.05;
+  task_compile_tolerance_ = 0.001;
+  retarget_state_ = RETARGET_IDLE;
+  retarget_move_time_ = 0.0;
+  actuator_id_table_.resize(256);
+  updateActuatorIdTable();
+  actuator_route_revision_ = 0;
+}
+
+RobotisManipulator::RobotisManipulator(const RobotisManipulator &robotis_manipulator)
+{
+  *this = robotis_manipulator;
+}
+
+RobotisManipulator &RobotisManipulator::operator=(const RobotisManipulator &robotis_manipulator)
+{
+  if(this == &robotis_manipulator)
+    return *this;
+
+  manipulator_ = robotis_manipulator.manipulator_;
+  trajectory_ = robotis_manipulator.trajectory_;
+  kinematics_ = robotis_manipulator.kinematics_;
+  dynamics_ = robotis_manipulator.dynamics_;
+  joint_actuator_ = robotis_manipulator.joint_actuator_;
+  tool_actuator_ = robotis_manipulator.tool_actuator_;
+  actuator_id_table_ = robotis_manipulator.actuator_id_table_;
+  actuator_id_table_revision_ = robotis_manipulator.actuator_id_table_revision_;
+  actuator_route_ = robotis_manipulator.actuator_route_;
+  actuator_route_revision_ = robotis_manipulator.actuator_route_revision_;
+
+  trajectory_initialized_state_ = robotis_manipulator.trajectory_initialized_state_;
+  moving_state_ = robotis_manipulator.moving_state_;
+  moving_fail_flag_ = robotis_manipulator.moving_fail_flag_;
+  step_moving_state_ = robotis_manipulator.step_moving_state_;
+
+  joint_actuator_added_stete_ = robotis_manipulator.joint_actuator_added_stete_;
+  tool_actuator_added_stete_ = robotis_manipulator.tool_actuator_added_stete_;
+  kinematics_added_state_ = robotis_manipulator.kinematics_added_state_;
+  dynamics_added_state_ = robotis_manipulator.dynamics_added_state_;
+
+  baking_control_period_ = robotis_manipulator.baking_control_period_;
+  baking_option_ = robotis_manipulator.baking_option_;
+  trajectory_table_state_ = robotis_manipulator.trajectory_table_state_;
+  trajectory_table_ = robotis_manipulator.trajectory_table_;
+  joint_limit_validated_state_ = robotis_manipulator.joint_limit_validated_state_;
+
+  task_compile_state_ = robotis_manipulator.task_compile_state_;
+  task_compile_knot_time_ = robotis_manipulator.task_compile_knot_time_;
+  task_compile_tolerance_ = robotis_manipulator.task_compile_tolerance_;
+
+  // The slot is only complete while it is ready
+  const bool retarget_ready = (robotis_manipulator.retarget_state_.load() == RETARGET_READY);
+  retarget_goal_joint_position_ = retarget_ready ? robotis_manipulator.retarget_goal_joint_position_ : std::vector<double>();
+  retarget_move_time_ = retarget_ready ? robotis_manipulator.retarget_move_time_ : 0.0;
+  retarget_state_.store(retarget_ready ? RETARGET_READY : RETARGET_IDLE);
+  return *this;
 }
 
 RobotisManipulator::~RobotisManipulator() {}
@@ -103,6 +223,8 @@ void RobotisManipulator::addKinematics(Kinematics *kinematics)
 {
   kinematics_= kinematics;
   kinematics_added_state_=true;
+  manipulator_.invalidateForwardKinematics();
+  trajectory_.getManipulator()->invalidateForwardKinematics();
 }
 
 void RobotisManipulator::addDynamics(Dynamics *dynamics)
@@ -126,9 +248,63 @@ void RobotisManipulator::addJointActuator(Name actuator_name, JointActuator *joi
   {
     manipulator_.setComponentActuatorName(manipulator_.findComponentNameUsingId(static_cast<int8_t>(id_array.at(index))),actuator_name);
   }
+  updateActuatorIdTable();
+  updateActuatorRoute();
   joint_actuator_added_stete_ = true;
 }
 
+void RobotisManipulator::updateActuatorIdTable()      //Private
+{
+  for(uint32_t id = 0; id < actuator_id_table_.size(); id++)
+  {
+    actuator_id_table_.at(id).component_index = -1;
+    actuator_id_table_.at(id).coefficient = 1.0;
+    actuator_id_table_.at(id).torque_coefficient = 1.0;
+  }
+  actuator_id_table_revision_ = manipulator_.getModelRevision();
+
+  // Active joints take slots [0, DOF) in the same order as the active joint vectors
+  const std::vector<uint8_t> &active_joint_id = manipulator_.getAllActiveJointID();
+  const std::vector<Name> &active_joint_name = manipulator_.getAllActiveJointComponentName();
+  for(uint8_t index = 0; index < active_joint_id.size(); index++)
+  {
+    ActuatorIdEntry &entry = actuator_id_table_.at(active_joint_id.at(index));
+    if(entry.component_index != -1)
+      continue;
+    entry.component_index = index;
+    entry.coefficient = manipulator_.getCoefficient(active_joint_name.at(index));
+    entry.torque_coefficient = manipulator_.getTorqueCoefficient(active_joint_name.at(index));
+  }
+}
+
+void RobotisManipulator::updateActuatorRoute()      //Private
+{
+  if(actuator_id_table_revision_ != manipulator_.getModelRevision())
+    updateActuatorIdTable();
+
+  actuator_route_.clear();
+  std::map<Name, JointActuator *>::iterator it_joint_actuator;
+  for(it_joint_actuator = joint_actuator_.begin(); it_joint_actuator != joint_actuator_.end(); it_joint_actuator++)
+  {
+    ActuatorRoute route;
+    route.actuator = it_joint_actuator->second;
+    std::vector<uint8_t> actuator_id = it_joint_actuator->second->getId();
+    for(uint32_t index = 0; index < actuator_id.size(); index++)
+    {
+      const ActuatorIdEntry &entry = actuator_id_table_.at(actuator_id.at(index));
+      if(entry.component_index == -1)
+        continue;
+      route.actuator_id.push_back(actuator_id.at(index));
+      route.component_index.push_back(entry.component_index);
+      route.inverse_coefficient.push_back(1.0 / entry.coefficient);
+      route.inverse_torque_coefficient.push_back(1.0 / entry.torque_coefficient);
+    }
+    route.value.resize(route.actuator_id.size());
+    actuator_route_.push_back(route);
+  }
+  actuator_route_revision_ = manipulator_.getModelRevision();
+}
+
 void RobotisManipulator::addToolActuator(Name actuator_name, ToolActuator *tool_actuator, uint8_t id, const void *arg)
 {
   tool_actuator_.insert(std::make_pair(actuator_name, tool_actuator));
@@ -165,7 +341,14 @@ Manipulator *RobotisManipulator::getManipulator()
 
 void RobotisManipulator::setTorqueCoefficient(Name component_name, double torque_coefficient)
 {
-  return manipulator_.setTorqueCoefficient(component_name, torque_coefficient);
+  manipulator_.setTorqueCoefficient(component_name, torque_coefficient);
+  updateActuatorIdTable();
+  updateActuatorRoute();
+}
+
+void RobotisManipulator::setJointDynamicLimit(Name component_name, double velocity_limit, double acceleration_limit, double jerk_limit)
+{
+  manipulator_.setJointDynamicLimit(component_name, velocity_limit, acceleration_limit, jerk_limit);
 }
 
 JointValue RobotisManipulator::getJointValue(Name joint_name)
@@ -236,7 +419,7 @@ Eigen::MatrixXd RobotisManipulator::jacobian(Name tool_name)
 void RobotisManipulator::solveForwardKinematics()
 {
   if(kinematics_added_state_){
-    kinematics_->solveForwardKinematics(&manipulator_);
+    kinematics_->updateForwardKinematics(&manipulator_);
   }
   else{
     log::warn("[solveForwardKinematics] Kinematics Class was not added.");
@@ -248,7 +431,7 @@ void RobotisManipulator::solveForwardKinematics(std::vector<JointValue> *goal_jo
   if(kinematics_added_state_){
     Manipulator temp_manipulator = manipulator_;
     temp_manipulator.setAllActiveJointValue(*goal_joint_value);
-    kinematics_->solveForwardKinematics(&temp_manipulator);
+    kinematics_->updateForwardKinematics(&temp_manipulator);
     *goal_joint_value = temp_manipulator.getAllActiveJointValue();
   }
   else{
@@ -314,7 +497,7 @@ bool RobotisManipulator::solveGravityTerm(std::map<Name, double> *joint_torque)
     std::vector<JointValue> present_joint_value = temp_manipulator.getAllActiveJointValue();
     present_joint_value = trajectory_.removeWaypointDynamicData(present_joint_value);
     temp_manipulator.setAllActiveJointValue(present_joint_value);
-    kinematics_->solveForwardKinematics(&temp_manipulator);
+    kinematics_->updateForwardKinematics(&temp_manipulator);
     return dynamics_->solveInverseDynamics(temp_manipulator, joint_torque);
   }
   else{
@@ -613,6 +796,7 @@ bool RobotisManipulator::sendMultipleJointActuatorValue(std::vector<Name> joint_
     for(it_joint_actuator = joint_actuator_.begin(); it_joint_actuator != joint_actuator_.end(); it_joint_actuator++)
     {
       single_actuator_id = joint_actuator_.at(it_joint_actuator->first)->getId();
+      single_value_vector.clear();
       for(uint32_t index = 0; index < single_actuator_id.size(); index++)
       {
         for(uint32_t index2=0; index2 < joint_id.size(); index2++)
@@ -640,41 +824,26 @@ bool RobotisManipulator::sendAllJointActuatorValue(std::vector<JointValue> value
 {
   if(joint_actuator_added_stete_)
   {
-    std::map<Name, Component>::iterator it;
-    std::vector<int8_t> joint_id;
-    size_t index = 0;
-    for (it = manipulator_.getIteratorBegin(); it != manipulator_.getIteratorEnd(); it++)
+    if(value_vector.size() != static_cast<uint32_t>(manipulator_.getDOF()))
     {
-      if(manipulator_.checkComponentType(it->first, ACTIVE_JOINT_COMPONENT))
-      {
-        double coefficient = manipulator_.getCoefficient(it->first);
-        double torque_coefficient = manipulator_.getTorqueCoefficient(it->first);
-        value_vector.at(index).position = value_vector.at(index).position / coefficient;
-        value_vector.at(index).velocity = value_vector.at(index).velocity / coefficient;
-        value_vector.at(index).acceleration = value_vector.at(index).acceleration / coefficient;
-        value_vector.at(index).effort = value_vector.at(index).effort / torque_coefficient;
-        joint_id.push_back(manipulator_.getId(it->first));
-        index++;
-      }
+      log::error("[sendAllJointActuatorValue] Wrong value size.");
+      return false;
     }
-
-    std::vector<uint8_t> single_actuator_id;
-    std::vector<JointValue> single_value_vector;
-    std::map<Name, JointActuator *>::iterator it_joint_actuator;
-    for(it_joint_actuator = joint_actuator_.begin(); it_joint_actuator != joint_actuator_.end(); it_joint_actuator++)
+    // The model may have been edited through getManipulator() since the route was built
+    if(actuator_route_revision_ != manipulator_.getModelRevision())
+      updateActuatorRoute();
+    for(uint32_t route_index = 0; route_index < actuator_route_.size(); route_index++)
     {
-      single_actuator_id = joint_actuator_.at(it_joint_actuator->first)->getId();
-      for(uint32_t index = 0; index < single_actuator_id.size(); index++)
+      ActuatorRoute &route = actuator_route_[route_index];
+      for(uint32_t index = 0; index < route.component_index.size(); index++)
       {
-        for(uint32_t index2=0; index2 < joint_id.size(); index2++)
-        {
-           if(single_actuator_id.at(index) == joint_id.at(index2))
-           {
-             single_value_vector.push_back(value_vector.at(index2));
-           }
-        }
+        const JointValue &value = value_vector[route.component_index[index]];
+        route.value[index].position = value.position * route.inverse_coefficient[index];
+        route.value[index].velocity = value.velocity * route.inverse_coefficient[index];
+        route.value[index].acceleration = value.acceleration * route.inverse_coefficient[index];
+        route.value[index].effort = value.effort * route.inverse_torque_coefficient[index];
       }
-      joint_actuator_.at(it_joint_actuator->first)->sendJointActuatorValue(single_actuator_id, single_value_vector);
+      route.actuator->sendJointActuatorValue(route.actuator_id, route.value);
     }
     return true;
   }
@@ -714,41 +883,41 @@ std::vector<JointValue> RobotisManipulator::receiveMultipleJointActuatorValue(st
 {
   if(joint_actuator_added_stete_)
   {
-    std::vector<JointValue> get_value_vector;
-    std::vector<uint8_t> get_actuator_id;
+    // The model may have been edited through getManipulator() since the table was built
+    if(actuator_id_table_revision_ != manipulator_.getModelRevision())
+      updateActuatorIdTable();
+
+    std::vector<JointValue> get_value_vector(manipulator_.getDOF());
+    std::vector<bool> received(manipulator_.getDOF(), false);
 
     std::vector<JointValue> single_value_vector;
     std::vector<uint8_t> single_actuator_id;
     std::map<Name, JointActuator *>::iterator it_joint_actuator;
     for(it_joint_actuator = joint_actuator_.begin(); it_joint_actuator != joint_actuator_.end(); it_joint_actuator++)
     {
-      single_actuator_id = joint_actuator_.at(it_joint_actuator->first)->getId();
-      single_value_vector = joint_actuator_.at(it_joint_actuator->first)->receiveJointActuatorValue(single_actuator_id);
-      for(uint32_t index=0; index < single_actuator_id.size(); index++)
+      single_actuator_id = it_joint_actuator->second->getId();
+      single_value_vector = it_joint_actuator->second->receiveJointActuatorValue(single_actuator_id);
+      for(uint32_t index = 0; index < single_actuator_id.size() && index < single_value_vector.size(); index++)
       {
-        get_actuator_id.push_back(single_actuator_id.at(index));
-        get_value_vector.push_back(single_value_vector.at(index));
+        const ActuatorIdEntry &entry = actuator_id_table_[single_actuator_id.at(index)];
+        if(entry.component_index == -1 || received.at(entry.component_index))
+          continue;
+        get_value_vector.at(entry.component_index).position = single_value_vector.at(index).position * entry.coefficient;
+        get_value_vector.at(entry.component_index).velocity = single_value_vector.at(index).velocity * entry.coefficient;
+        get_value_vector.at(entry.component_index).acceleration = single_value_vector.at(index).acceleration * entry.coefficient;
+        get_value_vector.at(entry.component_index).effort = single_value_vector.at(index).effort * entry.torque_coefficient;
+        received.at(entry.component_index) = true;
       }
     }
 
     std::vector<JointValue> result_vector;
-    JointValue result;
-
     for(uint32_t index = 0; index < joint_component_name.size(); index++)
     {
-      for(uint32_t index2 = 0; index2 < get_actuator_id.size(); index2++)
+      const ActuatorIdEntry &entry = actuator_id_table_[static_cast<uint8_t>(manipulator_.getId(joint_component_name.at(index)))];
+      if(entry.component_index != -1 && received.at(entry.component_index))
       {
-        if(manipulator_.getId(joint_component_name.at(index)) == get_actuator_id.at(index2))
-        {
-          double coefficient = manipulator_.getCoefficient(joint_component_name.at(index));
-          double torque_coefficient = manipulator_.getTorqueCoefficient(joint_component_name.at(index));
-          result.position = get_value_vector.at(index2).position * coefficient;
-          result.velocity = get_value_vector.at(index2).velocity * coefficient;
-          result.acceleration = get_value_vector.at(index2).acceleration * coefficient;
-          result.effort = get_value_vector.at(index2).effort * torque_coefficient;
-          manipulator_.setJointValue(joint_component_name.at(index), result);
-          result_vector.push_back(result);
-        }
+        manipulator_.setJointValue(joint_component_name.at(index), get_value_vector.at(entry.component_index));
+        result_vector.push_back(get_value_vector.at(entry.component_index));
       }
     }
 
@@ -761,42 +930,47 @@ std::vector<JointValue> RobotisManipulator::receiveAllJointActuatorValue()
 {
   if(joint_actuator_added_stete_)
   {
-    std::vector<JointValue> get_value_vector;
-    std::vector<uint8_t> get_actuator_id;
+    // The model may have been edited through getManipulator() since the table was built
+    if(actuator_id_table_revision_ != manipulator_.getModelRevision())
+      updateActuatorIdTable();
+
+    std::vector<JointValue> result_vector = manipulator_.getAllActiveJointValue();
+    std::vector<bool> received(result_vector.size(), false);
+    uint32_t received_size = 0;
+
     std::vector<JointValue> single_value_vector;
     std::vector<uint8_t> single_actuator_id;
-    for(auto it_joint_actuator = joint_actuator_.begin(); it_joint_actuator != joint_actuator_.end(); it_joint_actuator++)
+    std::map<Name, JointActuator *>::iterator it_joint_actuator;
+    for(it_joint_actuator = joint_actuator_.begin(); it_joint_actuator != joint_actuator_.end(); it_joint_actuator++)
     {
-      single_actuator_id = joint_actuator_.at(it_joint_actuator->first)->getId();
-      single_value_vector = joint_actuator_.at(it_joint_actuator->first)->receiveJointActuatorValue(single_actuator_id);
-
-      for(uint32_t index=0; index < single_actuator_id.size(); index++)
+      single_actuator_id = it_joint_actuator->second->getId();
+      single_value_vector = it_joint_actuator->second->receiveJointActuatorValue(single_actuator_id);
+      for(uint32_t index = 0; index < single_actuator_id.size() && index < single_value_vector.size(); index++)
       {
-        get_actuator_id.push_back(single_actuator_id.at(index));
-        get_value_vector.push_back(single_value_vector.at(index));
+        const ActuatorIdEntry &entry = actuator_id_table_[single_actuator_id.at(index)];
+        if(entry.component_index == -1 || received.at(entry.component_index))
+          continue;
+        JointValue &result = result_vector.at(entry.component_index);
+        result.position = single_value_vector.at(index).position * entry.coefficient;
+        result.velocity = single_value_vector.at(index).velocity * entry.coefficient;
+        result.acceleration = single_value_vector.at(index).acceleration * entry.coefficient;
+        result.effort = single_value_vector.at(index).effort * entry.torque_coefficient;
+        received.at(entry.component_index) = true;
+        received_size++;
       }
     }
+    manipulator_.setAllActiveJointValue(result_vector);
 
-    std::map<Name, Component>::iterator it;
-    std::vector<JointValue> result_vector;
-    JointValue result;
-    for (it = manipulator_.getIteratorBegin(); it != manipulator_.getIteratorEnd(); it++)
+    // Only the joints that answered are returned
+    if(received_size != result_vector.size())
     {
-      for(uint32_t index2 = 0; index2 < get_actuator_id.size(); index2++)
+      std::vector<JointValue> received_vector;
+      for(uint32_t index = 0; index < result_vector.size(); index++)
       {
-        if(manipulator_.checkComponentType(it->first,ACTIVE_JOINT_COMPONENT) && manipulator_.getId(it->first) == get_actuator_id.at(index2))
-        {
-          double coefficient = manipulator_.getCoefficient(it->first);
-          double torque_coefficient = manipulator_.getTorqueCoefficient(it->first);
-          result.position = get_value_vector.at(index2).position * coefficient;
-          result.velocity = get_value_vector.at(index2).velocity * coefficient;
-          result.acceleration = get_value_vector.at(index2).acceleration * coefficient;
-          result.effort = get_value_vector.at(index2).effort * torque_coefficient;
-          manipulator_.setJointValue(it->first, result);
-          result_vector.push_back(result);
-          break;
-        }
+        if(received.at(index))
+          received_vector.push_back(result_vector.at(index));
       }
+      return received_vector;
     }
     return result_vector;
   }
@@ -947,11 +1121,214 @@ std::vector<JointValue> RobotisManipulator::receiveAllToolActuatorValue()
 /*****************************************************************************
 ** Time Function
 *****************************************************************************/
-void RobotisManipulator::startMoving()      //Private
+bool RobotisManipulator::startMoving()      //Private
 {
-  moving_state_ = true;
+  trajectory_table_state_ = false;
+  joint_limit_validated_state_ = false;
   moving_fail_flag_ = false;
+  if(task_compile_state_ && (trajectory_.checkTrajectoryType(TASK_TRAJECTORY)
+                             || trajectory_.checkTrajectoryType(TASK_PATH_TRAJECTORY)
+                             || trajectory_.checkTrajectoryType(CUSTOM_TASK_TRAJECTORY)))
+  {
+    if(!compileTaskTrajectory())
+    {
+      moving_state_ = false;
+      moving_fail_flag_ = true;
+      return false;
+    }
+  }
+  if(trajectory_.checkTrajectoryType(JOINT_TRAJECTORY) || trajectory_.checkTrajectoryType(JOINT_S_CURVE_TRAJECTORY))
+  {
+    if(!checkJointTrajectoryLimit())
+    {
+      moving_state_ = false;
+      moving_fail_flag_ = true;
+      return false;
+    }
+    joint_limit_validated_state_ = true;
+  }
+  if(baking_control_period_ > 0.0 && !bakeTrajectory())
+  {
+    moving_state_ = false;
+    moving_fail_flag_ = true;
+    return false;
+  }
+  moving_state_ = true;
   trajectory_.setStartTimeToPresentTime();
+  return true;
+}
+
+bool RobotisManipulator::checkJointTrajectoryLimit()      //Private
+{
+  std::vector<Limit> position_extremum, velocity_extremum;
+  if(!trajectory_.getJointExtremum(&position_extremum, &velocity_extremum))
+    return true;
+
+  const std::vector<Name> &joint_name = trajectory_.getManipulator()->getAllActiveJointComponentName();
+  if(position_extremum.size() != joint_name.size())
+  {
+    log::error("[checkJointTrajectoryLimit] Wrong trajectory size.");
+    return false;
+  }
+  for(uint32_t index = 0; index < joint_name.size(); index++)
+  {
+    if(!trajectory_.getManipulator()->checkJointLimit(joint_name.at(index), position_extremum.at(index).maximum)
+       || !trajectory_.getManipulator()->checkJointLimit(joint_name.at(index), position_extremum.at(index).minimum))
+    {
+      log::error("[checkJointTrajectoryLimit] Trajectory exceeds position limit at " + STRING(joint_name.at(index)) + ".");
+      return false;
+    }
+    double velocity_limit = manipulator_.getVelocityLimit(joint_name.at(index));
+    if(velocity_limit > 0.0 && std::max(velocity_extremum.at(index).maximum, -velocity_extremum.at(index).minimum) > velocity_limit)
+    {
+      log::error("[checkJointTrajectoryLimit] Trajectory exceeds velocity limit at " + STRING(joint_name.at(index)) + ".");
+      return false;
+    }
+  }
+  return true;
+}
+
+bool RobotisManipulator::compileTaskTrajectory()      //Private
+{
+  if(!kinematics_added_state_)
+  {
+    log::error("[compileTaskTrajectory] Kinematics is not added.");
+    return false;
+  }
+  // IK and FK run on the trajectory manipulator, so restore it afterwards.
+  Manipulator manipulator_snapshot = *trajectory_.getManipulator();
+  Name tool_name = trajectory_.getPresentControlToolName();
+  double move_time = trajectory_.getMoveTime();
+  uint32_t interval_size = std::max(static_cast<uint32_t>(ceil(move_time / task_compile_knot_time_)), static_cast<uint32_t>(1));
+
+  TaskWaypoint goal_task_way_point;
+  trajectory_.getTaskWaypoint(move_time, &goal_task_way_point);
+  bool goal_at_rest = isTaskWaypointAtRest(goal_task_way_point);
+
+  // The spline starts at the present joint waypoint, so it starts where the joints are and at their velocity.
+  // The other knots are uniform, each IK seeded from the previous knot.
+  std::vector<double> knot_time(interval_size + 1, 0.0);
+  std::vector<JointWaypoint> knot_way_point(interval_size + 1);
+  knot_way_point.at(0) = trajectory_.getPresentJointWaypoint();
+  bool result = true;
+  for(uint32_t knot = 1; knot <= interval_size && result; knot++)
+  {
+    knot_time.at(knot) = move_time * knot / interval_size;
+    result = solveTaskKnot(knot_time.at(knot), knot_way_point.at(knot - 1), &knot_way_point.at(knot));
+  }
+
+  // Split every interval whose spline leaves the tolerance until all of them meet it
+  bool converged = false;
+  for(uint8_t round = 0; round < TASK_COMPILE_ROUND && result && !converged; round++)
+  {
+    setKnotDerivative(&knot_way_point, knot_time, goal_at_rest);
+    converged = true;
+
+    std::vector<double> refined_knot_time;
+    std::vector<JointWaypoint> refined_knot_way_point;
+    for(uint32_t knot = 0; knot + 1 < knot_time.size() && result; knot++)
+    {
+      refined_knot_time.push_back(knot_time.at(knot));
+      refined_knot_way_point.push_back(knot_way_point.at(knot));
+
+      double interval = knot_time.at(knot + 1) - knot_time.at(knot);
+      JointTrajectory segment;
+      segment.makeJointTrajectory(interval, knot_way_point.at(knot), knot_way_point.at(knot + 1));
+
+      bool in_tolerance = true;
+      for(uint8_t quarter = 1; quarter < 4 && in_tolerance; quarter++)
+      {
+        TaskWaypoint task_way_point;
+        trajectory_.getTaskWaypoint(knot_time.at(knot) + interval * quarter / 4.0, &task_way_point);
+        trajectory_.setPresentJointWaypoint(segment.getJointWaypoint(interval * quarter / 4.0));
+        kinematics_->updateForwardKinematics(trajectory_.getManipulator());
+        KinematicPose spline_pose = trajectory_.getManipulator()->getComponentKinematicPoseFromWorld(tool_name);
+
+        double position_error = (spline_pose.position - task_way_point.kinematic.position).norm();
+        double orientation_error = Eigen::AngleAxisd(task_way_point.kinematic.orientation.transpose() * spline_pose.orientation).angle();
+        in_tolerance = position_error <= task_compile_tolerance_ && orientation_error <= task_compile_tolerance_;
+      }
+      if(!in_tolerance)
+      {
+        converged = false;
+        JointWaypoint middle_way_point;
+        result = solveTaskKnot(knot_time.at(knot) + interval / 2.0, knot_way_point.at(knot), &middle_way_point);
+        refined_knot_time.push_back(knot_time.at(knot) + interval / 2.0);
+        refined_knot_way_point.push_back(middle_way_point);
+      }
+    }
+    refined_knot_time.push_back(knot_time.back());
+    refined_knot_way_point.push_back(knot_way_point.back());
+    knot_time.swap(refined_knot_time);
+    knot_way_point.swap(refined_knot_way_point);
+  }
+
+  trajectory_.setManipulator(manipulator_snapshot);
+  if(!result)
+    return false;
+  if(!converged)
+  {
+    log::error("[compileTaskTrajectory] Fail to meet the tolerance, the path may pass near a singularity.");
+    return false;
+  }
+
+  trajectory_.setTrajectoryType(JOINT_TRAJECTORY);
+  return trajectory_.makeJointSplineTrajectory(knot_way_point, knot_time);
+}
+
+bool RobotisManipulator::solveTaskKnot(double tick_time, JointWaypoint seed_way_point, JointWaypoint *knot_way_point)      //Private
+{
+  TaskWaypoint task_way_point;
+  trajectory_.getTaskWaypoint(tick_time, &task_way_point);
+  trajectory_.setPresentJointWaypoint(seed_way_point);
+  if(!kinematics_->solveInverseKinematics(trajectory_.getManipulator(), trajectory_.getPresentControlToolName(), task_way_point, knot_way_point))
+  {
+    log::error("[compileTaskTrajectory] Fail to solve IK at ", tick_time);
+    return false;
+  }
+  return checkJointLimit(trajectory_.getManipulator()->getAllActiveJointComponentName(), *knot_way_point);
+}
+
+bool RobotisManipulator::bakeTrajectory()      //Private
+{
+  // Sampling runs the trajectory on the trajectory manipulator, so restore it afterwards.
+  Manipulator manipulator_snapshot = *trajectory_.getManipulator();
+  double move_time = trajectory_.getMoveTime();
+  uint32_t joint_size = trajectory_.getManipulator()->getDOF();
+  uint32_t sample_size = static_cast<uint32_t>(ceil(move_time / baking_control_period_)) + 1;
+
+  trajectory_table_.control_period = baking_control_period_;
+  trajectory_table_.joint_size = joint_size;
+  trajectory_table_.sample_size = sample_size;
+  trajectory_table_.position.resize(sample_size * joint_size);
+  trajectory_table_.velocity.resize(sample_size * joint_size);
+  trajectory_table_.acceleration.resize(sample_size * joint_size);
+  trajectory_table_.effort.resize(sample_size * joint_size);
+
+  // The table is baked at full speed, the speed override is applied when it is read
+  for(uint32_t sample = 0; sample < sample_size; sample++)
+  {
+    double tick_time = std::min(sample * baking_control_period_, move_time);
+    JointWaypoint joint_way_point = getTrajectoryJointValue(tick_time, baking_option_);
+
+    if(moving_fail_flag_ || joint_way_point.size() != joint_size)
+    {
+      log::error("[bakeTrajectory] Fail to bake the trajectory at ", tick_time);
+      trajectory_.setManipulator(manipulator_snapshot);
+      return false;
+    }
+    for(uint32_t index = 0; index < joint_size; index++)
+    {
+      trajectory_table_.position[sample * joint_size + index] = joint_way_point[index].position;
+      trajectory_table_.velocity[sample * joint_size + index] = joint_way_point[index].velocity;
+      trajectory_table_.acceleration[sample * joint_size + index] = joint_way_point[index].acceleration;
+      trajectory_table_.effort[sample * joint_size + index] = joint_way_point[index].effort;
+    }
+  }
+
+  trajectory_.setManipulator(manipulator_snapshot);
+  trajectory_table_state_ = true;
+  return true;
 }
 
 double RobotisManipulator::getTrajectoryMoveTime()
@@ -1000,7 +1377,7 @@ bool RobotisManipulator::checkJointLimit(Name component_name, JointValue value)
   }
 }
 
-bool RobotisManipulator::checkJointLimit(std::vector<Name> component_name, std::vector<double> position_vector)
+bool RobotisManipulator::checkJointLimit(const std::vector<Name> &component_name, const std::vector<double> &position_vector)
 {
   for(uint32_t index = 0; index < component_name.size(); index++)
   {
@@ -1013,7 +1390,7 @@ bool RobotisManipulator::checkJointLimit(std::vector<Name> component_name, std::
   return true;
 }
 
-bool RobotisManipulator::checkJointLimit(std::vector<Name> component_name, std::vector<JointValue> value_vector)
+bool RobotisManipulator::checkJointLimit(const std::vector<Name> &component_name, const std::vector<JointValue> &value_vector)
 {
   for(uint32_t index = 0; index < component_name.size(); index++)
   {
@@ -1035,6 +1412,35 @@ Trajectory *RobotisManipulator::getTrajectory()
   return &trajectory_;
 }
 
+void RobotisManipulator::setSpeedOverride(double speed_override, double ramp_rate)
+{
+  trajectory_.setSpeedOverride(speed_override, ramp_rate);
+}
+
+double RobotisManipulator::getSpeedOverride()
+{
+  return trajectory_.getSpeedOverride();
+}
+
+void RobotisManipulator::setTrajectoryBaking(double control_period, int option)
+{
+  baking_control_period_ = control_period;
+  baking_option_ = option;
+  trajectory_table_state_ = false;
+}
+
+void RobotisManipulator::setTaskTrajectoryCompileOption(bool enable, double knot_time, double tolerance)
+{
+  if(knot_time <= 0.0 || tolerance <= 0.0)
+  {
+    log::error("[setTaskTrajectoryCompileOption] Knot time and tolerance should be positive.");
+    return;
+  }
+  task_compile_state_ = enable;
+  task_compile_knot_time_ = knot_time;
+  task_compile_tolerance_ = tolerance;
+}
+
 bool RobotisManipulator::makeJointTrajectoryFromPresentPosition(std::vector<double> delta_goal_joint_position, double move_time, std::vector<JointValue> present_joint_value)
 {
   if(present_joint_value.size() != 0)
@@ -1084,8 +1490,7 @@ bool RobotisManipulator::makeJointTrajectory(std::vector<double> goal_joint_posi
   if(!trajectory_.makeJointTrajectory(present_way_point, goal_way_point))
     return false;
 
-  startMoving();
-  return true;
+  return startMoving();
 }
 
 bool RobotisManipulator::makeJointTrajectory(std::vector<JointValue> goal_joint_value, double move_time, std::vector<JointValue> present_joint_value)
@@ -1108,11 +1513,149 @@ bool RobotisManipulator::makeJointTrajectory(std::vector<JointValue> goal_joint_
   }
   if(!trajectory_.makeJointTrajectory(present_way_point, goal_joint_value))
     return false;
-  startMoving();
+  return startMoving();
+}
 
+bool RobotisManipulator::makeJointTrajectory(std::vector<std::vector<double>> via_joint_position, std::vector<double> move_time, std::vector<JointValue> present_joint_value)
+{
+  trajectory_.setTrajectoryType(JOINT_TRAJECTORY);
+
+  if(present_joint_value.size() != 0)
+  {
+    trajectory_.setPresentJointWaypoint(present_joint_value);
+    trajectory_.updatePresentWaypoint(kinematics_);
+  }
+
+  JointWaypoint present_way_point = trajectory_.getPresentJointWaypoint();
+
+  std::vector<JointWaypoint> via_way_point;
+  for (uint32_t index = 0; index < via_joint_position.size(); index++)
+  {
+    if(via_joint_position.at(index).size() != present_way_point.size())
+    {
+      log::error("[makeJointTrajectory] Wrong via point size.");
+      return false;
+    }
+    JointWaypoint way_point = trajectory_.removeWaypointDynamicData(present_way_point);
+    setPositionToValue(&way_point, via_joint_position.at(index));
+    via_way_point.push_back(way_point);
+  }
+
+  if(getMovingState())
+  {
+    moving_state_=false;
+    while(!step_moving_state_);
+  }
+  if(!trajectory_.makeJointTrajectory(present_way_point, via_way_point, move_time))
+    return false;
+
+  return startMoving();
+}
+
+bool RobotisManipulator::makeJointSCurveTrajectory(std::vector<double> goal_joint_position, std::vector<JointValue> present_joint_value)
+{
+  trajectory_.setTrajectoryType(JOINT_S_CURVE_TRAJECTORY);
+
+  if(present_joint_value.size() != 0)
+  {
+    trajectory_.setPresentJointWaypoint(present_joint_value);
+    trajectory_.updatePresentWaypoint(kinematics_);
+  }
+
+  JointWaypoint present_way_point = trajectory_.getPresentJointWaypoint();
+  const std::vector<Name> &joint_name = manipulator_.getAllActiveJointComponentName();
+
+  if(goal_joint_position.size() != joint_name.size())
+  {
+    log::error("[makeJointSCurveTrajectory] Wrong goal joint size.");
+    return false;
+  }
+
+  JointValue goal_way_point_temp;
+  JointWaypoint goal_way_point;
+  std::vector<double> max_velocity, max_acceleration, max_jerk;
+  for (uint8_t index = 0; index < joint_name.size(); index++)
+  {
+    goal_way_point_temp.position = goal_joint_position.at(index);
+    goal_way_point_temp.velocity = 0.0;
+    goal_way_point_temp.acceleration = 0.0;
+    goal_way_point_temp.effort = 0.0;
+    goal_way_point.push_back(goal_way_point_temp);
+
+    max_velocity.push_back(manipulator_.getVelocityLimit(joint_name.at(index)));
+    max_acceleration.push_back(manipulator_.getAccelerationLimit(joint_name.at(index)));
+    max_jerk.push_back(manipulator_.getJerkLimit(joint_name.at(index)));
+  }
+
+  if(getMovingState())
+  {
+    moving_state_=false;
+    while(!step_moving_state_);
+  }
+  if(!trajectory_.makeJointSCurveTrajectory(present_way_point, goal_way_point, max_velocity, max_acceleration, max_jerk))
+    return false;
+
+  return startMoving();
+}
+
+bool RobotisManipulator::retargetJointTrajectory(std::vector<double> goal_joint_position, double move_time)
+{
+  // A target not taken yet is overwritten by the newer one
+  uint8_t state = RETARGET_IDLE;
+  if(!retarget_state_.compare_exchange_strong(state, RETARGET_WRITING))
+  {
+    state = RETARGET_READY;
+    if(!retarget_state_.compare_exchange_strong(state, RETARGET_WRITING))
+      return false;
+  }
+  retarget_goal_joint_position_ = goal_joint_position;
+  retarget_move_time_ = move_time;
+  retarget_state_.store(RETARGET_READY);
   return true;
 }
 
+void RobotisManipulator::applyJointRetarget()      //Private
+{
+  uint8_t state = RETARGET_READY;
+  if(!retarget_state_.compare_exchange_strong(state, RETARGET_READING))
+    return;
+
+  // The present waypoint is the output of the previous tick, so the new move starts there
+  JointWaypoint present_way_point = trajectory_.getPresentJointWaypoint();
+  JointWaypoint goal_way_point(present_way_point.size());
+  bool is_valid = (retarget_goal_joint_position_.size() == present_way_point.size());
+  for(uint8_t index = 0; is_valid && index < goal_way_point.size(); index++)
+  {
+    goal_way_point.at(index).position = retarget_goal_joint_position_.at(index);
+    goal_way_point.at(index).velocity = 0.0;
+    goal_way_point.at(index).acceleration = 0.0;
+    goal_way_point.at(index).effort = 0.0;
+  }
+  double move_time = retarget_move_time_;
+  retarget_state_.store(RETARGET_IDLE);
+
+  if(!is_valid)
+  {
+    log::error("[retargetJointTrajectory] Wrong goal joint size.");
+    return;
+  }
+
+  trajectory_.setTrajectoryType(JOINT_TRAJECTORY);
+  trajectory_.setMoveTime(move_time);
+  trajectory_.setStartTimeToPresentTime();
+  trajectory_table_state_ = false;
+  if(!trajectory_.makeJointTrajectory(present_way_point, goal_way_point) || !checkJointTrajectoryLimit())
+  {
+    joint_limit_validated_state_ = false;
+    stopMoving();
+    moving_fail_flag_ = true;
+    return;
+  }
+  joint_limit_validated_state_ = true;
+  moving_fail_flag_ = false;
+  moving_state_ = true;
+}
+
 bool RobotisManipulator::makeJointTrajectory(Name tool_name, Eigen::Vector3d goal_position, double move_time, std::vector<JointValue> present_joint_value)
 {
   if(present_joint_value.size() != 0)
@@ -1169,8 +1712,7 @@ bool RobotisManipulator::makeJointTrajectory(Name tool_name, KinematicPose goal_
     }
     if(!trajectory_.makeJointTrajectory(present_way_point, goal_joint_angle))
       return false;
-    startMoving();
-    return true;
+    return startMoving();
   }
   else
   {
@@ -1286,8 +1828,7 @@ bool RobotisManipulator::makeTaskTrajectory(Name tool_name, KinematicPose goal_p
 
     if(!trajectory_.makeTaskTrajectory(present_task_way_point, goal_task_way_point))
       return false;
-    startMoving();
-    return true;
+    return startMoving();
   }
   else
   {
@@ -1296,6 +1837,138 @@ bool RobotisManipulator::makeTaskTrajectory(Name tool_name, KinematicPose goal_p
   }
 }
 
+bool RobotisManipulator::makeTaskTrajectory(Name tool_name, std::vector<KinematicPose> via_pose, std::vector<double> move_time, std::vector<JointValue> present_joint_value)
+{
+  trajectory_.setTrajectoryType(TASK_TRAJECTORY);
+  trajectory_.setPresentControlToolName(tool_name);
+
+  if(present_joint_value.size() != 0)
+  {
+    trajectory_.setPresentJointWaypoint(present_joint_value);
+    trajectory_.updatePresentWaypoint(kinematics_);
+  }
+
+  TaskWaypoint present_task_way_point = trajectory_.getPresentTaskWaypoint(tool_name);
+
+  // Each via point is checked from the joints of the previous one, where the arm will be when it gets there
+  Manipulator via_manipulator = *trajectory_.getManipulator();
+  std::vector<TaskWaypoint> via_way_point;
+  std::vector<JointValue> via_joint_angle;
+  TaskWaypoint way_point;                                       // at rest, only the kinematic pose changes
+  way_point.dynamic.linear.velocity = Eigen::Vector3d::Zero();
+  way_point.dynamic.linear.acceleration = Eigen::Vector3d::Zero();
+  way_point.dynamic.angular.velocity = Eigen::Vector3d::Zero();
+  way_point.dynamic.angular.acceleration = Eigen::Vector3d::Zero();
+  for (uint32_t index = 0; index < via_pose.size(); index++)
+  {
+    way_point.kinematic = via_pose.at(index);
+    if(!kinematics_->solveInverseKinematics(&via_manipulator, tool_name, way_point, &via_joint_angle))
+    {
+      log::error("[TASK_TRAJECTORY] Fail to solve IK");
+      return false;
+    }
+    via_manipulator.setAllActiveJointValue(via_joint_angle);
+    via_way_point.push_back(way_point);
+  }
+
+  if(getMovingState())
+  {
+    moving_state_=false;
+    while(!step_moving_state_) ;
+  }
+
+  if(!trajectory_.makeTaskTrajectory(present_task_way_point, via_way_point, move_time))
+    return false;
+  return startMoving();
+}
+
+bool RobotisManipulator::makeTaskLineTrajectory(Name tool_name, Eigen::Vector3d goal_position, double move_time, std::vector<JointValue> present_joint_value)
+{
+  trajectory_.setTrajectoryType(TASK_PATH_TRAJECTORY);
+  trajectory_.setPresentControlToolName(tool_name);
+  trajectory_.setMoveTime(move_time);
+
+  if(present_joint_value.size() != 0)
+  {
+    trajectory_.setPresentJointWaypoint(present_joint_value);
+    trajectory_.updatePresentWaypoint(kinematics_);
+  }
+
+  TaskWaypoint present_task_way_point = trajectory_.getPresentTaskWaypoint(tool_name);
+
+  // Check the end of the path before replacing the present trajectory
+  TaskPathTrajectory task_path = trajectory_.getTaskPathTrajectory();
+  if(!task_path.makeLineTrajectory(move_time, present_task_way_point, goal_position))
+    return false;
+  Pose temp_goal_pose = trajectory_.removeWaypointDynamicData(task_path.getTaskWaypoint(move_time));
+  std::vector<JointValue> goal_joint_angle;
+  if(!kinematics_->solveInverseKinematics(trajectory_.getManipulator(), tool_name, temp_goal_pose, &goal_joint_angle))
+  {
+    log::error("[TASK_PATH_TRAJECTORY] Fail to solve IK");
+    return false;
+  }
+
+  if(getMovingState())
+  {
+    moving_state_=false;
+    while(!step_moving_state_) ;
+  }
+  if(!trajectory_.makeTaskLineTrajectory(present_task_way_point, goal_position))
+    return false;
+  return startMoving();
+}
+
+bool RobotisManipulator::makeTaskArcTrajectory(Name tool_name, Eigen::Vector3d center, Eigen::Vector3d axis, double angle, double move_time, std::vector<JointValue> present_joint_value)
+{
+  return makeTaskHelixTrajectory(tool_name, center, axis, angle, 0.0, move_time, present_joint_value);
+}
+
+bool RobotisManipulator::makeTaskHelixTrajectory(Name tool_name, Eigen::Vector3d center, Eigen::Vector3d axis, double angle, double pitch, double move_time, std::vector<JointValue> present_joint_value)
+{
+  trajectory_.setTrajectoryType(TASK_PATH_TRAJECTORY);
+  trajectory_.setPresentControlToolName(tool_name);
+  trajectory_.setMoveTime(move_time);
+
+  if(present_joint_value.size() != 0)
+  {
+    trajectory_.setPresentJointWaypoint(present_joint_value);
+    trajectory_.updatePresentWaypoint(kinematics_);
+  }
+
+  TaskWaypoint present_task_way_point = trajectory_.getPresentTaskWaypoint(tool_name);
+
+  // Check the end of the path before replacing the present trajectory
+  TaskPathTrajectory task_path = trajectory_.getTaskPathTrajectory();
+  if(!task_path.makeHelixTrajectory(move_time, present_task_way_point, center, axis, angle, pitch))
+    return false;
+  Pose temp_goal_pose = trajectory_.removeWaypointDynamicData(task_path.getTaskWaypoint(move_time));
+  std::vector<JointValue> goal_joint_angle;
+  if(!kinematics_->solveInverseKinematics(trajectory_.getManipulator(), tool_name, temp_goal_pose, &goal_joint_angle))
+  {
+    log::error("[TASK_PATH_TRAJECTORY] Fail to solve IK");
+    return false;
+  }
+
+  if(getMovingState())
+  {
+    moving_state_=false;
+    while(!step_moving_state_) ;
+  }
+  if(!trajectory_.makeTaskHelixTrajectory(present_task_way_point, center, axis, angle, pitch))
+    return false;
+  return startMoving();
+}
+
+void RobotisManipulator::setTaskPathAccelerationTimeRatio(double acceleration_time_ratio)
+{
+  trajectory_.getTaskPathTrajectory().setAccelerationTimeRatio(acceleration_time_ratio);
+}
+
+void RobotisManipulator::setTaskOrientationInterpolation(OrientationInterpolation orientation_interpolation)
+{
+  trajectory_.setOrientationInterpolation(orientation_interpolation);
+}
+
 void RobotisManipulator::setCustomTrajectoryOption(Name trajectory_name, const void* arg)
 {
   trajectory_.setCustomTrajectoryOption(trajectory_name, arg);
@@ -1322,8 +1995,7 @@ bool RobotisManipulator::makeCustomTrajectory(Name trajectory_name, Name tool_na
   }
   if(!trajectory_.makeCustomTrajectory(trajectory_name, present_task_way_point, arg))
     return false;
-  startMoving();
-  return true;
+  return startMoving();
 }
 
 bool RobotisManipulator::makeCustomTrajectory(Name trajectory_name, const void *arg, double move_time, std::vector<JointValue> present_joint_value)
@@ -1346,8 +2018,7 @@ bool RobotisManipulator::makeCustomTrajectory(Name trajectory_name, const void *
   }
   if(!trajectory_.makeCustomTrajectory(trajectory_name, present_joint_value, arg))
     return false;
-  startMoving();
-  return true;
+  return startMoving();
 }
 
 bool RobotisManipulator::sleepTrajectory(double wait_time, std::vector<JointValue> present_joint_value)
@@ -1372,8 +2043,7 @@ bool RobotisManipulator::sleepTrajectory(double wait_time, std::vector<JointValu
   }
   if(!trajectory_.makeJointTrajectory(present_joint_way_point, goal_way_point_vector))
     return false;
-  startMoving();
-  return true;
+  return startMoving();
 }
 
 bool RobotisManipulator::makeToolTrajectory(Name tool_name, double tool_goal_position)
@@ -1396,12 +2066,46 @@ JointWaypoint RobotisManipulator::getTrajectoryJointValue(double tick_time, int
 {
   JointWaypoint joint_way_point_value;
 
+  ////////////////////////Baked Trajectory/////////////////////////
+  if(trajectory_table_state_)
+  {
+    const TrajectoryTable &table = trajectory_table_;
+    uint32_t sample = 0;
+    if(tick_time > 0.0)
+      sample = std::min(static_cast<uint32_t>(tick_time / table.control_period + 0.5), table.sample_size - 1);
+
+    joint_way_point_value.resize(table.joint_size);
+    for(uint32_t index = 0; index < table.joint_size; index++)
+    {
+      joint_way_point_value[index].position = table.position[sample * table.joint_size + index];
+      joint_way_point_value[index].velocity = table.velocity[sample * table.joint_size + index];
+      joint_way_point_value[index].acceleration = table.acceleration[sample * table.joint_size + index];
+      joint_way_point_value[index].effort = table.effort[sample * table.joint_size + index];
+    }
+    //set present joint task value to trajectory manipulator
+    trajectory_.setPresentJointWaypoint(joint_way_point_value);
+    if(kinematics_added_state_){
+      trajectory_.updatePresentWaypoint(kinematics_);
+    }
+    return joint_way_point_value;
+  }
+  /////////////////////////////////////////////////////////////////
+
   ////////////////////////Joint Trajectory/////////////////////////
-  if(trajectory_.checkTrajectoryType(JOINT_TRAJECTORY))
+  if(trajectory_.checkTrajectoryType(JOINT_TRAJECTORY) || trajectory_.checkTrajectoryType(JOINT_S_CURVE_TRAJECTORY))
   {
-    joint_way_point_value = trajectory_.getJointTrajectory().getJointWaypoint(tick_time);
+    if(trajectory_.checkTrajectoryType(JOINT_S_CURVE_TRAJECTORY))
+    {
+      trajectory_.getJointSCurveTrajectory().getJointWaypoint(tick_time, &joint_way_point_value);
+    }
+    else
+    {
+      double segment_tick_time = trajectory_.updatePresentSegment(tick_time);
+      trajectory_.getJointTrajectory().getJointWaypoint(segment_tick_time, &joint_way_point_value);
+    }
 
-    if(!checkJointLimit(trajectory_.getManipulator()->getAllActiveJointComponentName(), joint_way_point_value))
+    // Limits of validated trajectories were checked over the whole move in startMoving()
+    if(!joint_limit_validated_state_ && !checkJointLimit(trajectory_.getManipulator()->getAllActiveJointComponentName(), joint_way_point_value))
     {
       joint_way_point_value = trajectory_.removeWaypointDynamicData(trajectory_.getPresentJointWaypoint());
       moving_fail_flag_ = true;
@@ -1416,10 +2120,18 @@ JointWaypoint RobotisManipulator::getTrajectoryJointValue(double tick_time, int
   /////////////////////////////////////////////////////////////////
   ///
   /////////////////////////Task Trajectory/////////////////////////
-  else if(trajectory_.checkTrajectoryType(TASK_TRAJECTORY))
+  else if(trajectory_.checkTrajectoryType(TASK_TRAJECTORY) || trajectory_.checkTrajectoryType(TASK_PATH_TRAJECTORY))
   {
     TaskWaypoint task_way_point;
-    task_way_point = trajectory_.getTaskTrajectory().getTaskWaypoint(tick_time);
+    if(trajectory_.checkTrajectoryType(TASK_PATH_TRAJECTORY))
+    {
+      trajectory_.getTaskPathTrajectory().getTaskWaypoint(tick_time, &task_way_point);
+    }
+    else
+    {
+      double segment_tick_time = trajectory_.updatePresentSegment(tick_time);
+      task_way_point = trajectory_.getTaskTrajectory().getTaskWaypoint(segment_tick_time);
+    }
 
     if(kinematics_->solveInverseKinematics(trajectory_.getManipulator(), trajectory_.getPresentControlToolName(), task_way_point, &joint_way_point_value))
     {
@@ -1496,9 +2208,19 @@ JointWaypoint RobotisManipulator::getTrajectoryJointValue(double tick_time, int
     std::map<Name, double> joint_torque_map;
     if(option == DYNAMICS_ALL_SOVING)
     {
+      // The actuators get the velocity and acceleration scaled by the speed override, so the effort is solved for them
+      if(trajectory_.getSpeedOverride() != 1.0)
+      {
+        JointWaypoint scaled_way_point = joint_way_point_value;
+        trajectory_.applySpeedOverride(&scaled_way_point);
+        trajectory_.setPresentJointWaypoint(scaled_way_point);
+        if(kinematics_added_state_){
+          trajectory_.updatePresentWaypoint(kinematics_);
+        }
+      }
       if(dynamics_->solveInverseDynamics(*trajectory_.getManipulator(), &joint_torque_map))
       {
-        auto names = trajectory_.getManipulator()->getAllActiveJointComponentName();
+        const std::vector<Name> &names = trajectory_.getManipulator()->getAllActiveJointComponentName();
         std::vector<double> joint_torque;
         for(uint8_t i = 0; i < names.size(); i++)
         {
@@ -1523,7 +2245,7 @@ JointWaypoint RobotisManipulator::getTrajectoryJointValue(double tick_time, int
 
       if(dynamics_->solveInverseDynamics(*trajectory_.getManipulator(), &joint_torque_map))
       {
-        auto names = trajectory_.getManipulator()->getAllActiveJointComponentName();
+        const std::vector<Name> &names = trajectory_.getManipulator()->getAllActiveJointComponentName();
         std::vector<double> joint_torque;
         for(uint8_t i = 0; i < names.size(); i++)
         {
@@ -1552,6 +2274,8 @@ JointWaypoint RobotisManipulator::getTrajectoryJointValue(double tick_time, int
 
 std::vector<JointValue> RobotisManipulator::getJointGoalValueFromTrajectory(double present_time, int option)
 {
+  if(trajectory_initialized_state_)
+    applyJointRetarget();
   trajectory_.setPresentTime(present_time);
 
   if(!trajectory_initialized_state_)
@@ -1580,6 +2304,8 @@ std::vector<JointValue> RobotisManipulator::getJointGoalValueFromTrajectory(doub
       joint_goal_way_point =  getTrajectoryJointValue(trajectory_.getMoveTime(), option);
     }
     step_moving_state_ = true;
+    // The present waypoint keeps the planned speed, so only the goal sent to the actuators is scaled
+    trajectory_.applySpeedOverride(&joint_goal_way_point);
     return joint_goal_way_point;
   }
   return {};
@@ -1611,6 +2337,8 @@ std::vector<JointValue> RobotisManipulator::getJointGoalValueFromTrajectoryTickT
       joint_goal_way_point = getTrajectoryJointValue(trajectory_.getMoveTime());
     }
     step_moving_state_ = true;
+    // The present waypoint keeps the planned speed, so only the goal sent to the actuators is scaled
+    trajectory_.applySpeedOverride(&joint_goal_way_point);
     return joint_goal_way_point;
   }
   return {};
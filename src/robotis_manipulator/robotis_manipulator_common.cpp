@@ -18,6 +18,8 @@
 
 #include "../../include/robotis_manipulator/robotis_manipulator_common.h"
 
+#include <atomic>
+
 using namespace robotis_manipulator;
 
 bool robotis_manipulator::setEffortToValue(std::vector<JointValue> *value, std::vector<double> effort)
@@ -46,7 +48,25 @@ bool robotis_manipulator::setPositionToValue(std::vector<JointValue> *value, std
   }
 }
 
-Manipulator::Manipulator():dof_(0){}
+namespace
+{
+// Process-wide so that two different models never share a revision
+uint32_t takeModelRevision()
+{
+  static std::atomic<uint32_t> revision(0);
+  return ++revision;
+}
+} // namespace
+
+Manipulator::Manipulator():state_version_(1), solved_state_version_(0), chain_stamp_(1)
+{
+  model_ = std::make_shared<ManipulatorModel>();
+  model_->revision = takeModelRevision();
+  model_->passive_joint_begin = 0;
+  model_->tool_begin = 0;
+  for (uint32_t id = 0; id < 256; id++)
+    model_->id_index[id] = -1;
+}
 
 /*****************************************************************************
 ** Add Function
@@ -64,6 +84,7 @@ void Manipulator::addWorld(Name world_name,
   world_.pose.dynamic.linear.acceleration = Eigen::Vector3d::Zero();
   world_.pose.dynamic.angular.velocity = Eigen::Vector3d::Zero();
   world_.pose.dynamic.angular.acceleration = Eigen::Vector3d::Zero();
+  touchChain();
 }
 
 void Manipulator::addJoint(Name my_name,
@@ -84,7 +105,6 @@ void Manipulator::addJoint(Name my_name,
   Component temp_component;
   if (joint_actuator_id != -1)
   {
-    dof_++;
     temp_component.component_type = ACTIVE_JOINT_COMPONENT;
   }
   else
@@ -105,6 +125,9 @@ void Manipulator::addJoint(Name my_name,
   temp_component.joint_constant.position_limit.maximum = max_position_limit;
   temp_component.joint_constant.position_limit.minimum = min_position_limit;
   temp_component.joint_constant.torque_coefficient = torque_coefficient;
+  temp_component.joint_constant.velocity_limit = 0.0;
+  temp_component.joint_constant.acceleration_limit = 0.0;
+  temp_component.joint_constant.jerk_limit = 0.0;
 
   temp_component.pose_from_world.kinematic.position = Eigen::Vector3d::Zero();
   temp_component.pose_from_world.kinematic.orientation = Eigen::Matrix3d::Identity();
@@ -117,7 +140,7 @@ void Manipulator::addJoint(Name my_name,
   temp_component.joint_value.velocity = 0.0;
   temp_component.joint_value.effort = 0.0;
 
-  component_.insert(std::make_pair(my_name, temp_component));
+  insertComponent(my_name, temp_component);
 }
 
 void Manipulator::addTool(Name my_name,
@@ -149,6 +172,9 @@ void Manipulator::addTool(Name my_name,
   temp_component.joint_constant.position_limit.maximum = max_position_limit;
   temp_component.joint_constant.position_limit.minimum = min_position_limit;
   temp_component.joint_constant.torque_coefficient = torque_coefficient;
+  temp_component.joint_constant.velocity_limit = 0.0;
+  temp_component.joint_constant.acceleration_limit = 0.0;
+  temp_component.joint_constant.jerk_limit = 0.0;
 
   temp_component.pose_from_world.kinematic.position = Eigen::Vector3d::Zero();
   temp_component.pose_from_world.kinematic.orientation = Eigen::Matrix3d::Identity();
@@ -161,19 +187,163 @@ void Manipulator::addTool(Name my_name,
   temp_component.joint_value.velocity = 0.0;
   temp_component.joint_value.effort = 0.0;
 
-  component_.insert(std::make_pair(my_name, temp_component));
+  insertComponent(my_name, temp_component);
+}
+
+ManipulatorModel *Manipulator::editModel()      //Private
+{
+  // Copy on write, the other holders keep the model they had
+  if (model_.use_count() > 1)
+    model_ = std::make_shared<ManipulatorModel>(*model_);
+  model_->revision = takeModelRevision();
+  return model_.get();
+}
+
+void Manipulator::insertComponent(Name component_name, Component component)      //Private
+{
+  if (model_->component_index.find(component_name) != model_->component_index.end())
+  {
+    log::error("[insertComponent] Component already exists.");
+    return;
+  }
+  ComponentModel component_model;
+  component_model.name = component.name;
+  component_model.component_type = component.component_type;
+  component_model.relative = component.relative;
+  component_model.joint_constant = component.joint_constant;
+  component_model.actuator_name = component.actuator_name;
+
+  ComponentState component_state;
+  component_state.pose_from_world = component.pose_from_world;
+  component_state.joint_value = component.joint_value;
+
+  ManipulatorModel *model = editModel();
+  model->component_name.push_back(component_name);
+  model->component.push_back(component_model);
+  state_.push_back(component_state);
+  updateComponentLayout(model);
+}
+
+void Manipulator::updateComponentLayout(ManipulatorModel *model)      //Private
+{
+  // Active joints, passive joints and tools, each group in name order
+  const ComponentType group_type[3] = {ACTIVE_JOINT_COMPONENT, PASSIVE_JOINT_COMPONENT, TOOL_COMPONENT};
+  std::map<Name, uint8_t> name_order;
+  for (uint8_t index = 0; index < model->component.size(); index++)
+    name_order.insert(std::make_pair(model->component_name.at(index), index));
+
+  std::vector<uint8_t> order;
+  for (uint8_t group = 0; group < 3; group++)
+  {
+    if (group_type[group] == PASSIVE_JOINT_COMPONENT) model->passive_joint_begin = order.size();
+    if (group_type[group] == TOOL_COMPONENT) model->tool_begin = order.size();
+    for (std::map<Name, uint8_t>::iterator it = name_order.begin(); it != name_order.end(); it++)
+    {
+      if (model->component.at(it->second).component_type == group_type[group])
+        order.push_back(it->second);
+    }
+  }
+
+  std::vector<ComponentModel> component;
+  std::vector<Name> component_name;
+  std::vector<ComponentState> state;
+  model->component_index.clear();
+  for (uint8_t index = 0; index < order.size(); index++)
+  {
+    component.push_back(model->component.at(order.at(index)));
+    component_name.push_back(model->component_name.at(order.at(index)));
+    state.push_back(state_.at(order.at(index)));
+    model->component_index.insert(std::make_pair(component_name.back(), index));
+  }
+  model->component.swap(component);
+  model->component_name.swap(component_name);
+  state_.swap(state);
+
+  model->joint_index.clear();
+  for (std::map<Name, uint8_t>::iterator it = model->component_index.begin(); it != model->component_index.end(); it++)
+  {
+    if (it->second < model->tool_begin)
+      model->joint_index.push_back(it->second);
+  }
+  joint_stamp_.assign(model->component.size(), 0);
+  pose_stamp_.assign(model->component.size(), 0);
+  updateComponentView(model);
+}
+
+void Manipulator::updateComponentView(ManipulatorModel *model)      //Private
+{
+  model->active_joint_index.clear();
+  model->active_joint_name.clear();
+  model->active_joint_id.clear();
+  for (uint8_t index = 0; index < model->passive_joint_begin; index++)
+  {
+    model->active_joint_index.push_back(index);
+    model->active_joint_name.push_back(model->component_name[index]);
+    model->active_joint_id.push_back(model->component[index].joint_constant.id);
+  }
+
+  model->tool_name.assign(model->component_name.begin() + model->tool_begin, model->component_name.end());
+
+  model->joint_id.clear();
+  for (uint8_t index = 0; index < model->joint_index.size(); index++)
+    model->joint_id.push_back(model->component[model->joint_index[index]].joint_constant.id);
+
+  for (uint32_t id = 0; id < 256; id++)
+    model->id_index[id] = -1;
+  for (std::map<Name, uint8_t>::iterator it = model->component_index.begin(); it != model->component_index.end(); it++)
+  {
+    uint8_t id = static_cast<uint8_t>(model->component[it->second].joint_constant.id);
+    if (model->id_index[id] == -1)
+      model->id_index[id] = it->second;
+  }
+
+  model->parent_index.assign(model->component.size(), -1);
+  for (uint8_t index = 0; index < model->component.size(); index++)
+  {
+    std::map<Name, uint8_t>::const_iterator parent = model->component_index.find(model->component[index].name.parent);
+    if (parent != model->component_index.end())
+      model->parent_index[index] = parent->second;
+  }
+  touchChain();
+}
+
+void Manipulator::writeJointPosition(uint8_t index, double position)      //Private
+{
+  if (state_[index].joint_value.position != position)
+  {
+    state_[index].joint_value.position = position;
+    joint_stamp_[index] = ++state_version_;
+  }
+}
+
+void Manipulator::writeJointValue(uint8_t index, const JointValue &joint_value)      //Private
+{
+  writeJointPosition(index, joint_value.position);
+  state_[index].joint_value = joint_value;
+}
+
+void Manipulator::touchPose(uint8_t index)      //Private
+{
+  pose_stamp_[index] = ++state_version_;
+}
+
+void Manipulator::touchChain()      //Private
+{
+  chain_stamp_ = ++state_version_;
 }
 
 void Manipulator::addComponentChild(Name my_name, Name child_name)
 {
-  component_.at(my_name).name.child.push_back(child_name);
+  ManipulatorModel *model = editModel();
+  model->component[model->component_index.at(my_name)].name.child.push_back(child_name);
+  touchChain();
 }
 
 void Manipulator::printManipulatorSetting()
 {
   log::println("----------<Manipulator Description>----------");
-  log::println("<Degree of Freedom>\n", dof_);
-  log::println("<Number of Components>\n", component_.size());
+  log::println("<Degree of Freedom>\n", model_->passive_joint_begin);
+  log::println("<Number of Components>\n", model_->component.size());
   log::println("");
   log::println("<World Configuration>");
   log::println(" [Name]");
@@ -195,70 +365,73 @@ void Manipulator::printManipulatorSetting()
   log::print_vector(world_.pose.dynamic.angular.acceleration);
 
   std::vector<double> result_vector;
-  std::map<Name, Component>::iterator it_component;
+  std::map<Name, uint8_t>::iterator it_component;
 
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
+  for (it_component = model_->component_index.begin(); it_component != model_->component_index.end(); it_component++)
   {
     log::println("");
     log::println("<"); log::print(STRING(it_component->first)); log::print("Configuration>");
-    if(component_.at(it_component->first).component_type == ACTIVE_JOINT_COMPONENT)
+    if(model_->component[it_component->second].component_type == ACTIVE_JOINT_COMPONENT)
       log::println(" [Component Type]\n  Active Joint");
-    else if(component_.at(it_component->first).component_type == PASSIVE_JOINT_COMPONENT)
+    else if(model_->component[it_component->second].component_type == PASSIVE_JOINT_COMPONENT)
       log::println(" [Component Type]\n  Passive Joint");
-    else if(component_.at(it_component->first).component_type == TOOL_COMPONENT)
+    else if(model_->component[it_component->second].component_type == TOOL_COMPONENT)
       log::println(" [Component Type]\n  Tool");
     log::println(" [Name]");
-    log::print(" -Parent Name : "); log::println(STRING(component_.at(it_component->first).name.parent));
-    for(uint32_t index = 0; index < component_.at(it_component->first).name.child.size(); index++)
+    log::print(" -Parent Name : "); log::println(STRING(model_->component[it_component->second].name.parent));
+    for(uint32_t index = 0; index < model_->component[it_component->second].name.child.size(); index++)
     {
       log::print(" -Child Name",index+1,0);
       log::print(" : ");
-      log::println(STRING(component_.at(it_component->first).name.child.at(index)));
+      log::println(STRING(model_->component[it_component->second].name.child.at(index)));
     }
     log::println(" [Actuator]");
     log::print(" -Actuator Name : ");
-    log::println(STRING(component_.at(it_component->first).actuator_name));
+    log::println(STRING(model_->component[it_component->second].actuator_name));
     log::print(" -ID : ");
-    log::println("", component_.at(it_component->first).joint_constant.id,0);
+    log::println("", model_->component[it_component->second].joint_constant.id,0);
     log::println(" -Joint Axis : ");
-    log::print_vector(component_.at(it_component->first).joint_constant.axis);
+    log::print_vector(model_->component[it_component->second].joint_constant.axis);
     log::print(" -Coefficient : ");
-    log::println("", component_.at(it_component->first).joint_constant.coefficient);
+    log::println("", model_->component[it_component->second].joint_constant.coefficient);
     log::println(" -Position Limit : ");
-    log::print("    Maximum :", component_.at(it_component->first).joint_constant.position_limit.maximum);
-    log::println(", Minimum :", component_.at(it_component->first).joint_constant.position_limit.minimum);
+    log::print("    Maximum :", model_->component[it_component->second].joint_constant.position_limit.maximum);
+    log::println(", Minimum :", model_->component[it_component->second].joint_constant.position_limit.minimum);
+    log::println(" -Velocity Limit : ", model_->component[it_component->second].joint_constant.velocity_limit);
+    log::println(" -Acceleration Limit : ", model_->component[it_component->second].joint_constant.acceleration_limit);
+    log::println(" -Jerk Limit : ", model_->component[it_component->second].joint_constant.jerk_limit);
 
     log::println(" [Actuator Value]");
-    log::println(" -Position : ", component_.at(it_component->first).joint_value.position);
-    log::println(" -Velocity : ", component_.at(it_component->first).joint_value.velocity);
-    log::println(" -Acceleration : ", component_.at(it_component->first).joint_value.acceleration);
-    log::println(" -Effort : ", component_.at(it_component->first).joint_value.effort);
+    log::println(" -Position : ", state_[it_component->second].joint_value.position);
+    log::println(" -Velocity : ", state_[it_component->second].joint_value.velocity);
+    log::println(" -Acceleration : ", state_[it_component->second].joint_value.acceleration);
+    log::println(" -Effort : ", state_[it_component->second].joint_value.effort);
 
     log::println(" [Constant]");
     log::println(" -Relative Position from parent component : ");
-    log::print_vector(component_.at(it_component->first).relative.pose_from_parent.position);
+    log::print_vector(model_->component[it_component->second].relative.pose_from_parent.position);
     log::println(" -Relative Orientation from parent component : ");
-    log::print_matrix(component_.at(it_component->first).relative.pose_from_parent.orientation);
+    log::print_matrix(model_->component[it_component->second].relative.pose_from_parent.orientation);
     log::print(" -Mass : ");
-    log::println("", component_.at(it_component->first).relative.inertia.mass);
+    log::println("", model_->component[it_component->second].relative.inertia.mass);
     log::println(" -Inertia Tensor : ");
-    log::print_matrix(component_.at(it_component->first).relative.inertia.inertia_tensor);
+    log::print_matrix(model_->component[it_component->second].relative.inertia.inertia_tensor);
     log::println(" -Center of Mass : ");
-    log::print_vector(component_.at(it_component->first).relative.inertia.center_of_mass);
+    log::print_vector(model_->component[it_component->second].relative.inertia.center_of_mass);
 
     log::println(" [Variable]");
     log::println(" -Position : ");
-    log::print_vector(component_.at(it_component->first).pose_from_world.kinematic.position);
+    log::print_vector(state_[it_component->second].pose_from_world.kinematic.position);
     log::println(" -Orientation : ");
-    log::print_matrix(component_.at(it_component->first).pose_from_world.kinematic.orientation);
+    log::print_matrix(state_[it_component->second].pose_from_world.kinematic.orientation);
     log::println(" -Linear Velocity : ");
-    log::print_vector(component_.at(it_component->first).pose_from_world.dynamic.linear.velocity);
+    log::print_vector(state_[it_component->second].pose_from_world.dynamic.linear.velocity);
     log::println(" -Linear acceleration : ");
-    log::print_vector(component_.at(it_component->first).pose_from_world.dynamic.linear.acceleration);
+    log::print_vector(state_[it_component->second].pose_from_world.dynamic.linear.acceleration);
     log::println(" -Angular Velocity : ");
-    log::print_vector(component_.at(it_component->first).pose_from_world.dynamic.angular.velocity);
+    log::print_vector(state_[it_component->second].pose_from_world.dynamic.angular.velocity);
     log::println(" -Angular acceleration : ");
-    log::print_vector(component_.at(it_component->first).pose_from_world.dynamic.angular.acceleration);
+    log::print_vector(state_[it_component->second].pose_from_world.dynamic.angular.acceleration);
   }
   log::println("---------------------------------------------");
 }
@@ -269,27 +442,41 @@ void Manipulator::printManipulatorSetting()
 *****************************************************************************/
 void Manipulator::setTorqueCoefficient(Name component_name, double torque_coefficient)
 {
-  component_.at(component_name).joint_constant.torque_coefficient = torque_coefficient;
+  ManipulatorModel *model = editModel();
+  model->component[model->component_index.at(component_name)].joint_constant.torque_coefficient = torque_coefficient;
+}
+
+void Manipulator::setJointDynamicLimit(Name component_name, double velocity_limit, double acceleration_limit, double jerk_limit)
+{
+  ManipulatorModel *model = editModel();
+  JointConstant &joint_constant = model->component[model->component_index.at(component_name)].joint_constant;
+  joint_constant.velocity_limit = velocity_limit;
+  joint_constant.acceleration_limit = acceleration_limit;
+  joint_constant.jerk_limit = jerk_limit;
 }
 
 void Manipulator::setWorldPose(Pose world_pose)
 {
   world_.pose = world_pose;
+  touchChain();
 }
 
 void Manipulator::setWorldKinematicPose(KinematicPose world_kinematic_pose)
 {
   world_.pose.kinematic = world_kinematic_pose;
+  touchChain();
 }
 
 void Manipulator::setWorldPosition(Eigen::Vector3d world_position)
 {
   world_.pose.kinematic.position = world_position;
+  touchChain();
 }
 
 void Manipulator::setWorldOrientation(Eigen::Matrix3d world_orientation)
 {
   world_.pose.kinematic.orientation = world_orientation;
+  touchChain();
 }
 
 void Manipulator::setWorldDynamicPose(DynamicPose world_dynamic_pose)
@@ -319,19 +506,35 @@ void Manipulator::setWorldAngularAcceleration(Eigen::Vector3d world_angular_acce
 
 void Manipulator::setComponent(Name component_name, Component component)
 {
-  component_.at(component_name) = component;
+  ManipulatorModel *model = editModel();
+  uint8_t index = model->component_index.at(component_name);
+  ComponentType component_type = model->component[index].component_type;
+  model->component[index].name = component.name;
+  model->component[index].component_type = component.component_type;
+  model->component[index].relative = component.relative;
+  model->component[index].joint_constant = component.joint_constant;
+  model->component[index].actuator_name = component.actuator_name;
+  state_[index].pose_from_world = component.pose_from_world;
+  writeJointValue(index, component.joint_value);
+  if (component.component_type != component_type)
+    updateComponentLayout(model);
+  else
+    updateComponentView(model);
 }
 
 void Manipulator::setComponentActuatorName(Name component_name, Name actuator_name)
 {
-  component_.at(component_name).actuator_name = actuator_name;
+  ManipulatorModel *model = editModel();
+  model->component[model->component_index.at(component_name)].actuator_name = actuator_name;
 }
 
 void Manipulator::setComponentPoseFromWorld(Name component_name, Pose pose_to_world)
 {
-  if (component_.find(component_name) != component_.end())
+  std::map<Name, uint8_t>::iterator it = model_->component_index.find(component_name);
+  if (it != model_->component_index.end())
   {
-    component_.at(component_name).pose_from_world = pose_to_world;
+    state_[it->second].pose_from_world = pose_to_world;
+    touchPose(it->second);
   }
   else
   {
@@ -341,9 +544,11 @@ void Manipulator::setComponentPoseFromWorld(Name component_name, Pose pose_to_wo
 
 void Manipulator::setComponentKinematicPoseFromWorld(Name component_name, KinematicPose pose_to_world)
 {
-  if (component_.find(component_name) != component_.end())
+  std::map<Name, uint8_t>::iterator it = model_->component_index.find(component_name);
+  if (it != model_->component_index.end())
   {
-    component_.at(component_name).pose_from_world.kinematic = pose_to_world;
+    state_[it->second].pose_from_world.kinematic = pose_to_world;
+    touchPose(it->second);
   }
   else
   {
@@ -353,9 +558,11 @@ void Manipulator::setComponentKinematicPoseFromWorld(Name component_name, Kinema
 
 void Manipulator::setComponentPositionFromWorld(Name component_name, Eigen::Vector3d position_to_world)
 {
-  if (component_.find(component_name) != component_.end())
+  std::map<Name, uint8_t>::iterator it = model_->component_index.find(component_name);
+  if (it != model_->component_index.end())
   {
-    component_.at(component_name).pose_from_world.kinematic.position = position_to_world;
+    state_[it->second].pose_from_world.kinematic.position = position_to_world;
+    touchPose(it->second);
   }
   else
   {
@@ -365,9 +572,11 @@ void Manipulator::setComponentPositionFromWorld(Name component_name, Eigen::Vect
 
 void Manipulator::setComponentOrientationFromWorld(Name component_name, Eigen::Matrix3d orientation_to_wolrd)
 {
-  if (component_.find(component_name) != component_.end())
+  std::map<Name, uint8_t>::iterator it = model_->component_index.find(component_name);
+  if (it != model_->component_index.end())
   {
-    component_.at(component_name).pose_from_world.kinematic.orientation = orientation_to_wolrd;
+    state_[it->second].pose_from_world.kinematic.orientation = orientation_to_wolrd;
+    touchPose(it->second);
   }
   else
   {
@@ -377,9 +586,11 @@ void Manipulator::setComponentOrientationFromWorld(Name component_name, Eigen::M
 
 void Manipulator::setComponentDynamicPoseFromWorld(Name component_name, DynamicPose dynamic_pose)
 {
-  if (component_.find(component_name) != component_.end())
+  std::map<Name, uint8_t>::iterator it = model_->component_index.find(component_name);
+  if (it != model_->component_index.end())
   {
-    component_.at(component_name).pose_from_world.dynamic = dynamic_pose;
+    state_[it->second].pose_from_world.dynamic = dynamic_pose;
+    touchPose(it->second);
   }
   else
   {
@@ -389,120 +600,63 @@ void Manipulator::setComponentDynamicPoseFromWorld(Name component_name, DynamicP
 
 void Manipulator::setJointPosition(Name component_name, double position)
 {
-  component_.at(component_name).joint_value.position = position;
+  writeJointPosition(model_->component_index.at(component_name), position);
 }
 
 void Manipulator::setJointVelocity(Name component_name, double velocity)
 {
-  component_.at(component_name).joint_value.velocity = velocity;
+  state_[model_->component_index.at(component_name)].joint_value.velocity = velocity;
 }
 
 void Manipulator::setJointAcceleration(Name component_name, double acceleration)
 {
-  component_.at(component_name).joint_value.acceleration = acceleration;
+  state_[model_->component_index.at(component_name)].joint_value.acceleration = acceleration;
 }
 
 void Manipulator::setJointEffort(Name component_name, double effort)
 {
-  component_.at(component_name).joint_value.effort = effort;
+  state_[model_->component_index.at(component_name)].joint_value.effort = effort;
 }
 
 void Manipulator::setJointValue(Name component_name, JointValue joint_value)
 {
-  component_.at(component_name).joint_value = joint_value;
+  writeJointValue(model_->component_index.at(component_name), joint_value);
 }
 
 void Manipulator::setAllActiveJointPosition(std::vector<double> joint_position_vector)
 {
-  int8_t index = 0;
-  std::map<Name, Component>::iterator it_component;
-
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (component_.at(it_component->first).component_type == ACTIVE_JOINT_COMPONENT)
-    {
-      component_.at(it_component->first).joint_value.position = joint_position_vector.at(index);
-      index++;
-    }
-  }
+  for (uint8_t index = 0; index < model_->passive_joint_begin; index++)
+    writeJointPosition(index, joint_position_vector.at(index));
 }
 
 void Manipulator::setAllActiveJointValue(std::vector<JointValue> joint_value_vector)
 {
-  int8_t index = 0;
-  std::map<Name, Component>::iterator it_component;
-
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (component_.at(it_component->first).component_type == ACTIVE_JOINT_COMPONENT)
-    {
-      component_.at(it_component->first).joint_value.position = joint_value_vector.at(index).position;
-      component_.at(it_component->first).joint_value.velocity = joint_value_vector.at(index).velocity;
-      component_.at(it_component->first).joint_value.acceleration = joint_value_vector.at(index).acceleration;
-      component_.at(it_component->first).joint_value.effort = joint_value_vector.at(index).effort;
-      index++;
-    }
-  }
+  for (uint8_t index = 0; index < model_->passive_joint_begin; index++)
+    writeJointValue(index, joint_value_vector.at(index));
 }
 
 void Manipulator::setAllJointPosition(std::vector<double> joint_position_vector)
 {
-  int8_t index = 0;
-  std::map<Name, Component>::iterator it_component;
-
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (component_.at(it_component->first).component_type == ACTIVE_JOINT_COMPONENT || component_.at(it_component->first).component_type == PASSIVE_JOINT_COMPONENT)
-    {
-      component_.at(it_component->first).joint_value.position = joint_position_vector.at(index);
-      index++;
-    }
-  }
+  for (uint8_t index = 0; index < model_->joint_index.size(); index++)
+    writeJointPosition(model_->joint_index[index], joint_position_vector.at(index));
 }
 
 void Manipulator::setAllJointValue(std::vector<JointValue> joint_value_vector)
 {
-  int8_t index = 0;
-  std::map<Name, Component>::iterator it_component;
-
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (component_.at(it_component->first).component_type == ACTIVE_JOINT_COMPONENT || component_.at(it_component->first).component_type == PASSIVE_JOINT_COMPONENT)
-    {
-      component_.at(it_component->first).joint_value = joint_value_vector.at(index);
-      index++;
-    }
-  }
+  for (uint8_t index = 0; index < model_->joint_index.size(); index++)
+    writeJointValue(model_->joint_index[index], joint_value_vector.at(index));
 }
 
 void Manipulator::setAllToolPosition(std::vector<double> tool_position_vector)
 {
-  int8_t index = 0;
-  std::map<Name, Component>::iterator it_component;
-
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (component_.at(it_component->first).component_type == TOOL_COMPONENT)
-    {
-      component_.at(it_component->first).joint_value.position = tool_position_vector.at(index);
-      index++;
-    }
-  }
+  for (uint8_t index = model_->tool_begin; index < model_->component.size(); index++)
+    writeJointPosition(index, tool_position_vector.at(index - model_->tool_begin));
 }
 
 void Manipulator::setAllToolValue(std::vector<JointValue> tool_value_vector)
 {
-  int8_t index = 0;
-  std::map<Name, Component>::iterator it_component;
-
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (component_.at(it_component->first).component_type == TOOL_COMPONENT)
-    {
-      component_.at(it_component->first).joint_value = tool_value_vector.at(index);
-      index++;
-    }
-  }
+  for (uint8_t index = model_->tool_begin; index < model_->component.size(); index++)
+    writeJointValue(index, tool_value_vector.at(index - model_->tool_begin));
 }
 
 
@@ -511,7 +665,7 @@ void Manipulator::setAllToolValue(std::vector<JointValue> tool_value_vector)
 *****************************************************************************/
 int8_t Manipulator::getDOF()
 {
-  return dof_;
+  return model_->passive_joint_begin;
 }
 
 Name Manipulator::getWorldName()
@@ -551,216 +705,232 @@ DynamicPose Manipulator::getWorldDynamicPose()
 
 int8_t Manipulator::getComponentSize()
 {
-  return component_.size();
+  return model_->component.size();
 }
 
 std::map<Name, Component> Manipulator::getAllComponent()
 {
-  return component_;
+  std::map<Name, Component> all_component;
+  for (uint8_t index = 0; index < model_->component.size(); index++)
+    all_component.insert(std::make_pair(model_->component_name[index], getComponent(model_->component_name[index])));
+  return all_component;
+}
+
+ComponentIterator Manipulator::getIteratorBegin() const
+{
+  return ComponentIterator(this, model_->component_index.begin());
+}
+
+ComponentIterator Manipulator::getIteratorEnd() const
+{
+  return ComponentIterator(this, model_->component_index.end());
 }
 
-std::map<Name, Component>::iterator Manipulator::getIteratorBegin()
+uint8_t Manipulator::getComponentIndex(Name component_name)
 {
-  return component_.begin();
+  return model_->component_index.at(component_name);
 }
 
-std::map<Name, Component>::iterator Manipulator::getIteratorEnd()
+Name Manipulator::getComponentName(uint8_t component_index)
 {
-  return component_.end();;
+  return model_->component_name.at(component_index);
 }
 
 Component Manipulator::getComponent(Name component_name)
 {
-  return component_.at(component_name);
+  return getComponentUsingIndex(model_->component_index.at(component_name));
+}
+
+Component Manipulator::getComponentUsingIndex(uint8_t index) const
+{
+  Component component;
+  getComponentUsingIndex(index, &component);
+  return component;
+}
+
+void Manipulator::getComponentUsingIndex(uint8_t index, Component *component) const
+{
+  component->name = model_->component[index].name;
+  component->component_type = model_->component[index].component_type;
+  component->relative = model_->component[index].relative;
+  component->joint_constant = model_->component[index].joint_constant;
+  component->pose_from_world = state_[index].pose_from_world;
+  component->joint_value = state_[index].joint_value;
+  component->actuator_name = model_->component[index].actuator_name;
 }
 
 Name Manipulator::getComponentActuatorName(Name component_name)
 {
-  return component_.at(component_name).actuator_name;
+  return model_->component[model_->component_index.at(component_name)].actuator_name;
 }
 
 Name Manipulator::getComponentParentName(Name component_name)
 {
-  return component_.at(component_name).name.parent;
+  return model_->component[model_->component_index.at(component_name)].name.parent;
 }
 
 std::vector<Name> Manipulator::getComponentChildName(Name component_name)
 {
-  return component_.at(component_name).name.child;
+  return model_->component[model_->component_index.at(component_name)].name.child;
 }
 
 Pose Manipulator::getComponentPoseFromWorld(Name component_name)
 {
-  return component_.at(component_name).pose_from_world;
+  return state_[model_->component_index.at(component_name)].pose_from_world;
 }
 
 KinematicPose Manipulator::getComponentKinematicPoseFromWorld(Name component_name)
 {
-  return component_.at(component_name).pose_from_world.kinematic;
+  return state_[model_->component_index.at(component_name)].pose_from_world.kinematic;
 }
 
 Eigen::Vector3d Manipulator::getComponentPositionFromWorld(Name component_name)
 {
-  return component_.at(component_name).pose_from_world.kinematic.position;
+  return state_[model_->component_index.at(component_name)].pose_from_world.kinematic.position;
 }
 
 Eigen::Matrix3d Manipulator::getComponentOrientationFromWorld(Name component_name)
 {
-  return component_.at(component_name).pose_from_world.kinematic.orientation;
+  return state_[model_->component_index.at(component_name)].pose_from_world.kinematic.orientation;
 }
 
 DynamicPose Manipulator::getComponentDynamicPoseFromWorld(Name component_name)
 {
-  return component_.at(component_name).pose_from_world.dynamic;
+  return state_[model_->component_index.at(component_name)].pose_from_world.dynamic;
 }
 
 KinematicPose Manipulator::getComponentRelativePoseFromParent(Name component_name)
 {
-  return component_.at(component_name).relative.pose_from_parent;
+  return model_->component[model_->component_index.at(component_name)].relative.pose_from_parent;
 }
 
 Eigen::Vector3d Manipulator::getComponentRelativePositionFromParent(Name component_name)
 {
-  return component_.at(component_name).relative.pose_from_parent.position;
+  return model_->component[model_->component_index.at(component_name)].relative.pose_from_parent.position;
 }
 
 Eigen::Matrix3d Manipulator::getComponentRelativeOrientationFromParent(Name component_name)
 {
-  return component_.at(component_name).relative.pose_from_parent.orientation;
+  return model_->component[model_->component_index.at(component_name)].relative.pose_from_parent.orientation;
 }
 
 int8_t Manipulator::getId(Name component_name)
 {
-  return component_.at(component_name).joint_constant.id;
+  return model_->component[model_->component_index.at(component_name)].joint_constant.id;
 }
 
 double Manipulator::getCoefficient(Name component_name)
 {
-  return component_.at(component_name).joint_constant.coefficient;
+  return model_->component[model_->component_index.at(component_name)].joint_constant.coefficient;
 }
 
 double Manipulator::getTorqueCoefficient(Name component_name)
 {
-  return component_.at(component_name).joint_constant.torque_coefficient;
+  return model_->component[model_->component_index.at(component_name)].joint_constant.torque_coefficient;
+}
+
+double Manipulator::getVelocityLimit(Name component_name)
+{
+  return model_->component[model_->component_index.at(component_name)].joint_constant.velocity_limit;
+}
+
+double Manipulator::getAccelerationLimit(Name component_name)
+{
+  return model_->component[model_->component_index.at(component_name)].joint_constant.acceleration_limit;
+}
+
+double Manipulator::getJerkLimit(Name component_name)
+{
+  return model_->component[model_->component_index.at(component_name)].joint_constant.jerk_limit;
 }
 
 Eigen::Vector3d Manipulator::getAxis(Name component_name)
 {
-  return component_.at(component_name).joint_constant.axis;
+  return model_->component[model_->component_index.at(component_name)].joint_constant.axis;
 }
 
 double Manipulator::getJointPosition(Name component_name)
 {
-  return component_.at(component_name).joint_value.position;
+  return state_[model_->component_index.at(component_name)].joint_value.position;
 }
 
 double Manipulator::getJointVelocity(Name component_name)
 {
-  return component_.at(component_name).joint_value.velocity;
+  return state_[model_->component_index.at(component_name)].joint_value.velocity;
 }
 
 double Manipulator::getJointAcceleration(Name component_name)
 {
-  return component_.at(component_name).joint_value.acceleration;
+  return state_[model_->component_index.at(component_name)].joint_value.acceleration;
 }
 
 double Manipulator::getJointEffort(Name component_name)
 {
-  return component_.at(component_name).joint_value.effort;
+  return state_[model_->component_index.at(component_name)].joint_value.effort;
 }
 
 JointValue Manipulator::getJointValue(Name component_name)
 {
-  return component_.at(component_name).joint_value;
+  return state_[model_->component_index.at(component_name)].joint_value;
 }
 
 double Manipulator::getComponentMass(Name component_name)
 {
-  return component_.at(component_name).relative.inertia.mass;
+  return model_->component[model_->component_index.at(component_name)].relative.inertia.mass;
 }
 
 Eigen::Matrix3d Manipulator::getComponentInertiaTensor(Name component_name)
 {
-  return component_.at(component_name).relative.inertia.inertia_tensor;
+  return model_->component[model_->component_index.at(component_name)].relative.inertia.inertia_tensor;
 }
 
 Eigen::Vector3d Manipulator::getComponentCenterOfMass(Name component_name)
 {
-  return component_.at(component_name).relative.inertia.center_of_mass;
+  return model_->component[model_->component_index.at(component_name)].relative.inertia.center_of_mass;
 }
 
 std::vector<double> Manipulator::getAllJointPosition()
 {
   std::vector<double> result_vector;
-  std::map<Name, Component>::iterator it_component;
-
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (checkComponentType(it_component->first, ACTIVE_JOINT_COMPONENT) || checkComponentType(it_component->first, PASSIVE_JOINT_COMPONENT))
-    {
-      result_vector.push_back(component_.at(it_component->first).joint_value.position);
-    }
-  }
+  result_vector.reserve(model_->joint_index.size());
+  for (uint8_t index = 0; index < model_->joint_index.size(); index++)
+    result_vector.push_back(state_[model_->joint_index[index]].joint_value.position);
   return result_vector;
 }
 
 std::vector<JointValue> Manipulator::getAllJointValue()
 {
   std::vector<JointValue> result_vector;
-  std::map<Name, Component>::iterator it_component;
-
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (checkComponentType(it_component->first, ACTIVE_JOINT_COMPONENT) || checkComponentType(it_component->first, PASSIVE_JOINT_COMPONENT))
-    {
-      result_vector.push_back(component_.at(it_component->first).joint_value);
-    }
-  }
+  result_vector.reserve(model_->joint_index.size());
+  for (uint8_t index = 0; index < model_->joint_index.size(); index++)
+    result_vector.push_back(state_[model_->joint_index[index]].joint_value);
   return result_vector;
 }
 
 std::vector<double> Manipulator::getAllActiveJointPosition()
 {
   std::vector<double> result_vector;
-  std::map<Name, Component>::iterator it_component;
-
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (checkComponentType(it_component->first, ACTIVE_JOINT_COMPONENT))
-    {
-      result_vector.push_back(component_.at(it_component->first).joint_value.position);
-    }
-  }
+  result_vector.reserve(model_->passive_joint_begin);
+  for (uint8_t index = 0; index < model_->passive_joint_begin; index++)
+    result_vector.push_back(state_[index].joint_value.position);
   return result_vector;
 }
 
 std::vector<JointValue> Manipulator::getAllActiveJointValue()
 {
   std::vector<JointValue> result_vector;
-  std::map<Name, Component>::iterator it_component;
-
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (checkComponentType(it_component->first, ACTIVE_JOINT_COMPONENT))
-    {
-      result_vector.push_back(component_.at(it_component->first).joint_value);
-    }
-  }
+  result_vector.reserve(model_->passive_joint_begin);
+  for (uint8_t index = 0; index < model_->passive_joint_begin; index++)
+    result_vector.push_back(state_[index].joint_value);
   return result_vector;
 }
 
 std::vector<double> Manipulator::getAllToolPosition()
 {
   std::vector<double> result_vector;
-  std::map<Name, Component>::iterator it_component;
-
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (checkComponentType(it_component->first, TOOL_COMPONENT))
-    {
-      result_vector.push_back(component_.at(it_component->first).joint_value.position);
-    }
-  }
+  result_vector.reserve(model_->component.size() - model_->tool_begin);
+  for (uint8_t index = model_->tool_begin; index < model_->component.size(); index++)
+    result_vector.push_back(state_[index].joint_value.position);
   return result_vector;
 }
 
@@ -768,77 +938,41 @@ std::vector<double> Manipulator::getAllToolPosition()
 std::vector<JointValue> Manipulator::getAllToolValue()
 {
   std::vector<JointValue> result_vector;
-  std::map<Name, Component>::iterator it_component;
-
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (checkComponentType(it_component->first, TOOL_COMPONENT))
-    {
-      result_vector.push_back(component_.at(it_component->first).joint_value);
-    }
-  }
+  result_vector.reserve(model_->component.size() - model_->tool_begin);
+  for (uint8_t index = model_->tool_begin; index < model_->component.size(); index++)
+    result_vector.push_back(state_[index].joint_value);
   return result_vector;
 }
 
-std::vector<uint8_t> Manipulator::getAllJointID()
+const std::vector<uint8_t> &Manipulator::getAllJointID()
 {
-  std::vector<uint8_t> joint_id;
-  std::map<Name, Component>::iterator it_component;
-
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (checkComponentType(it_component->first, ACTIVE_JOINT_COMPONENT) || checkComponentType(it_component->first, PASSIVE_JOINT_COMPONENT))
-    {
-      joint_id.push_back(component_.at(it_component->first).joint_constant.id);
-    }
-  }
-  return joint_id;
+  return model_->joint_id;
 }
 
-std::vector<uint8_t> Manipulator::getAllActiveJointID()
+const std::vector<uint8_t> &Manipulator::getAllActiveJointID()
 {
-  std::vector<uint8_t> active_joint_id;
-  std::map<Name, Component>::iterator it_component;
-
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (checkComponentType(it_component->first, ACTIVE_JOINT_COMPONENT))
-    {
-      active_joint_id.push_back(component_.at(it_component->first).joint_constant.id);
-    }
-  }
-  return active_joint_id;
+  return model_->active_joint_id;
 }
 
 
-std::vector<Name> Manipulator::getAllToolComponentName()
+const std::vector<Name> &Manipulator::getAllToolComponentName()
 {
-  std::vector<Name> tool_name;
-  std::map<Name, Component>::iterator it_component;
+  return model_->tool_name;
+}
 
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (checkComponentType(it_component->first, TOOL_COMPONENT))
-    {
-      tool_name.push_back(it_component->first);
-    }
-  }
-  return tool_name;
+const std::vector<Name> &Manipulator::getAllActiveJointComponentName()
+{
+  return model_->active_joint_name;
 }
 
-std::vector<Name> Manipulator::getAllActiveJointComponentName()
+const std::vector<uint8_t> &Manipulator::getAllJointIndex()
 {
-  std::vector<Name> active_joint_name;
-  std::map<Name, Component>::iterator it_component;
+  return model_->joint_index;
+}
 
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
-  {
-    if (checkComponentType(it_component->first, ACTIVE_JOINT_COMPONENT))
-    {
-      active_joint_name.push_back(it_component->first);
-    }
-  }
-  return active_joint_name;
+const std::vector<uint8_t> &Manipulator::getAllActiveJointIndex()
+{
+  return model_->active_joint_index;
 }
 
 
@@ -847,9 +981,9 @@ std::vector<Name> Manipulator::getAllActiveJointComponentName()
 *****************************************************************************/
 bool Manipulator::checkJointLimit(Name component_name, double value)
 {
-  if(component_.at(component_name).joint_constant.position_limit.maximum < value)
+  if(model_->component[model_->component_index.at(component_name)].joint_constant.position_limit.maximum < value)
     return false;
-  else if(component_.at(component_name).joint_constant.position_limit.minimum > value)
+  else if(model_->component[model_->component_index.at(component_name)].joint_constant.position_limit.minimum > value)
     return false;
   else
     return true;
@@ -857,7 +991,7 @@ bool Manipulator::checkJointLimit(Name component_name, double value)
 
 bool Manipulator::checkComponentType(Name component_name, ComponentType component_type)
 {
-  if(component_.at(component_name).component_type == component_type)
+  if(model_->component[model_->component_index.at(component_name)].component_type == component_type)
     return true;
   else
     return false;
@@ -869,14 +1003,148 @@ bool Manipulator::checkComponentType(Name component_name, ComponentType componen
 *****************************************************************************/
 Name Manipulator::findComponentNameUsingId(int8_t id)
 {
-  std::map<Name, Component>::iterator it_component;
+  int16_t index = model_->id_index[static_cast<uint8_t>(id)];
+  if (index == -1)
+    return {};
+  return model_->component_name[index];
+}
 
-  for (it_component = component_.begin(); it_component != component_.end(); it_component++)
+int16_t Manipulator::findComponentIndexUsingId(int8_t id)
+{
+  return model_->id_index[static_cast<uint8_t>(id)];
+}
+
+
+/*****************************************************************************
+** Forward Kinematics State
+*****************************************************************************/
+uint64_t Manipulator::getStateVersion() const
+{
+  return state_version_;
+}
+
+bool Manipulator::isForwardKinematicsSolved() const
+{
+  return state_version_ == solved_state_version_;
+}
+
+bool Manipulator::isComponentPoseOutdated(Name component_name) const
+{
+  std::map<Name, uint8_t>::const_iterator it = model_->component_index.find(component_name);
+  if (it == model_->component_index.end())
   {
-    if (component_.at(it_component->first).joint_constant.id == id)
-    {
-      return it_component->first;
-    }
+    log::error("[isComponentPoseOutdated] Wrong name.");
+    return true;
   }
-  return {};
+  if (chain_stamp_ > solved_state_version_ || pose_stamp_[it->second] > solved_state_version_)
+    return true;
+
+  // The pose follows the joint positions from the world down to the component
+  int16_t index = it->second;
+  for (uint8_t depth = 0; index >= 0 && depth < model_->component.size(); depth++, index = model_->parent_index[index])
+  {
+    if (joint_stamp_[index] > solved_state_version_)
+      return true;
+  }
+  return false;
+}
+
+bool Manipulator::isComponentStateOutdatedUsingIndex(uint8_t component_index) const
+{
+  return chain_stamp_ > solved_state_version_ ||
+         joint_stamp_[component_index] > solved_state_version_ ||
+         pose_stamp_[component_index] > solved_state_version_;
+}
+
+void Manipulator::markForwardKinematicsSolved()
+{
+  solved_state_version_ = state_version_;
+}
+
+void Manipulator::invalidateForwardKinematics()
+{
+  touchChain();
+}
+
+
+/*****************************************************************************
+** Model
+*****************************************************************************/
+std::shared_ptr<const ManipulatorModel> Manipulator::getModel() const
+{
+  return model_;
+}
+
+uint32_t Manipulator::getModelRevision() const
+{
+  return model_->revision;
+}
+
+const ComponentState &Manipulator::getComponentStateUsingIndex(uint8_t component_index) const
+{
+  return state_[component_index];
+}
+
+void Manipulator::setComponentKinematicPoseUsingIndex(uint8_t component_index, const KinematicPose &pose_to_world)
+{
+  state_[component_index].pose_from_world.kinematic = pose_to_world;
+  touchPose(component_index);
+}
+
+void Manipulator::setJointPositionUsingIndex(uint8_t component_index, double position)
+{
+  writeJointPosition(component_index, position);
+}
+
+
+/*****************************************************************************
+** Component Iterator
+*****************************************************************************/
+ComponentIterator::ComponentIterator(const Manipulator *manipulator, std::map<Name, uint8_t>::const_iterator it)
+  : manipulator_(manipulator), it_(it), value_valid_(false)
+{}
+
+ComponentIterator::reference ComponentIterator::operator*() const
+{
+  if (!value_valid_)
+  {
+    value_.first = it_->first;
+    manipulator_->getComponentUsingIndex(it_->second, &value_.second);
+    value_valid_ = true;
+  }
+  return value_;
+}
+
+ComponentIterator::pointer ComponentIterator::operator->() const
+{
+  return &operator*();
+}
+
+ComponentIterator &ComponentIterator::operator++()
+{
+  it_++;
+  value_valid_ = false;
+  return *this;
+}
+
+ComponentIterator ComponentIterator::operator++(int)
+{
+  ComponentIterator previous = *this;
+  operator++();
+  return previous;
+}
+
+bool ComponentIterator::operator==(const ComponentIterator &other) const
+{
+  return it_ == other.it_;
+}
+
+bool ComponentIterator::operator!=(const ComponentIterator &other) const
+{
+  return it_ != other.it_;
+}
+
+uint8_t ComponentIterator::getComponentIndex() const
+{
+  return it_->second;
 }
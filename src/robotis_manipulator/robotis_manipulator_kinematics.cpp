@@ -0,0 +1,1010 @@
+/*******************************************************************************
+* Copyright 2018 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/* Authors: Darby Lim, Hye-Jong KIM, Ryan Shim, Yong-Ho Na */
+
+#include "../../include/robotis_manipulator/robotis_manipulator_kinematics.h"
+
+#include <algorithm>
+
+using namespace robotis_manipulator;
+
+namespace
+{
+// Same as math::rodriguesRotationMatrix, fixed-size and inlined. A zero axis gives the identity.
+inline Eigen::Matrix3d exponentialRotation(const Eigen::Vector3d &axis, double angle)
+{
+  Eigen::Matrix3d skew_symmetric_matrix;
+  skew_symmetric_matrix <<         0.0, -axis(2),  axis(1),
+                               axis(2),      0.0, -axis(0),
+                              -axis(1),  axis(0),      0.0;
+  return Eigen::Matrix3d::Identity() +
+         skew_symmetric_matrix * std::sin(angle) +
+         skew_symmetric_matrix * skew_symmetric_matrix * (1.0 - std::cos(angle));
+}
+
+// Angle in [-pi, pi)
+inline double wrapAngle(double angle)
+{
+  return angle - 2.0 * M_PI * std::floor((angle + M_PI) / (2.0 * M_PI));
+}
+
+// Rotation of v about the unit axis
+inline Eigen::Vector3d rotateVector(const Eigen::Vector3d &axis, double angle, const Eigen::Vector3d &v)
+{
+  const double cosine = std::cos(angle);
+  return v * cosine + axis.cross(v) * std::sin(angle) + axis * axis.dot(v) * (1.0 - cosine);
+}
+
+// Angle about the unit axis that turns p onto q, both at the same distance from the axis.
+// Any angle does it if p is on the axis, free_angle is returned then.
+inline double rotationAngle(const Eigen::Vector3d &axis, const Eigen::Vector3d &p, const Eigen::Vector3d &q, double free_angle = 0.0)
+{
+  const Eigen::Vector3d p_projection = p - axis * axis.dot(p);
+  const Eigen::Vector3d q_projection = q - axis * axis.dot(q);
+  if (p_projection.squaredNorm() < 1E-18)
+    return free_angle;
+  return std::atan2(axis.dot(p_projection.cross(q_projection)), p_projection.dot(q_projection));
+}
+
+// Angles about two unit axes through the origin that turn p onto q, rotation about axis_2 first
+inline uint8_t rotationAngle(const Eigen::Vector3d &axis_1, const Eigen::Vector3d &axis_2,
+                             const Eigen::Vector3d &p, const Eigen::Vector3d &q,
+                             double angle_1[2], double angle_2[2], double free_angle_1)
+{
+  const double cosine = axis_1.dot(axis_2);
+  const double alpha = (cosine * axis_2.dot(p) - axis_1.dot(q)) / (cosine * cosine - 1.0);
+  const double beta = (cosine * axis_1.dot(q) - axis_2.dot(p)) / (cosine * cosine - 1.0);
+  const Eigen::Vector3d normal = axis_1.cross(axis_2);
+  const double gamma_square = (p.squaredNorm() - alpha * alpha - beta * beta - 2.0 * alpha * beta * cosine) / normal.squaredNorm();
+  if (gamma_square < -1E-9)
+    return 0;
+
+  const double gamma = std::sqrt(std::max(gamma_square, 0.0));
+  for (uint8_t branch = 0; branch < 2; branch++)
+  {
+    const Eigen::Vector3d middle = alpha * axis_1 + beta * axis_2 + (branch == 0 ? gamma : -gamma) * normal;
+    angle_2[branch] = rotationAngle(axis_2, p, middle);
+    angle_1[branch] = rotationAngle(axis_1, middle, q, free_angle_1);
+  }
+  return 2;
+}
+} // namespace
+
+/*****************************************************************************
+** Product of Exponentials Kinematics
+*****************************************************************************/
+void PoEKinematics::setOption(const void *arg)
+{
+  (void)arg;
+}
+
+Eigen::MatrixXd PoEKinematics::jacobian(Manipulator *manipulator, Name tool_name)
+{
+  int16_t tool_index = findToolIndex(manipulator, tool_name);
+  if (tool_index < 0)
+    return Eigen::MatrixXd::Zero(6, manipulator->getDOF());
+
+  updateForwardKinematics(manipulator);
+  Eigen::MatrixXd jacobian;
+  fillJacobian(manipulator, tool_index, &jacobian);
+  return jacobian;
+}
+
+void PoEKinematics::solveForwardKinematics(Manipulator *manipulator)
+{
+  solveChain(manipulator, -1, nullptr);
+}
+
+bool PoEKinematics::solveForwardKinematicsAndJacobian(Manipulator *manipulator, Name tool_name, Eigen::MatrixXd *jacobian)
+{
+  int16_t tool_index = findToolIndex(manipulator, tool_name);
+  if (tool_index < 0)
+    return false;
+
+  solveChain(manipulator, tool_index, jacobian);
+  return true;
+}
+
+bool PoEKinematics::solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue>* goal_joint_position)
+{
+  const double lambda = 0.7;
+  const int8_t iteration = 30;
+
+  Manipulator goal_manipulator = *manipulator;
+  std::vector<double> joint_position = goal_manipulator.getAllActiveJointPosition();
+
+  for (int8_t count = 0; count < iteration; count++)
+  {
+    if (!solveForwardKinematicsAndJacobian(&goal_manipulator, tool_name, &jacobian_))
+      return false;
+
+    pose_difference_ = math::poseDifference(target_pose.kinematic.position, goal_manipulator.getComponentPositionFromWorld(tool_name),
+                                            target_pose.kinematic.orientation, goal_manipulator.getComponentOrientationFromWorld(tool_name));
+    if (pose_difference_.norm() < 1E-6)
+    {
+      *goal_joint_position = goal_manipulator.getAllActiveJointValue();
+      return true;
+    }
+
+    delta_position_ = lambda * jacobian_.colPivHouseholderQr().solve(pose_difference_);
+    for (uint8_t index = 0; index < joint_position.size(); index++)
+      joint_position[index] += delta_position_(index);
+    goal_manipulator.setAllActiveJointPosition(joint_position);
+  }
+  log::error("[PoEKinematics] Fail to solve inverse kinematics.");
+  return false;
+}
+
+const ManipulatorModel &PoEKinematics::updateModel(Manipulator *manipulator)
+{
+  if (model_ != nullptr && model_->revision == manipulator->getModelRevision())
+    return *model_;
+
+  model_ = manipulator->getModel();
+  const ManipulatorModel &model = *model_;
+
+  // Breadth first from the components below the world
+  traversal_order_.clear();
+  for (uint8_t index = 0; index < model.component.size(); index++)
+  {
+    if (model.parent_index[index] < 0)
+      traversal_order_.push_back(index);
+  }
+  for (uint8_t order = 0; order < traversal_order_.size(); order++)
+  {
+    for (uint8_t index = 0; index < model.component.size(); index++)
+    {
+      if (model.parent_index[index] == traversal_order_[order])
+        traversal_order_.push_back(index);
+    }
+  }
+  return model;
+}
+
+int16_t PoEKinematics::findToolIndex(Manipulator *manipulator, Name tool_name)
+{
+  const ManipulatorModel &model = updateModel(manipulator);
+  std::map<Name, uint8_t>::const_iterator it = model.component_index.find(tool_name);
+  if (it == model.component_index.end())
+  {
+    log::error("[PoEKinematics] Wrong tool name.");
+    return -1;
+  }
+  return it->second;
+}
+
+void PoEKinematics::solveChain(Manipulator *manipulator, int16_t tool_index, Eigen::MatrixXd *jacobian)      //Private
+{
+  const ManipulatorModel &model = updateModel(manipulator);
+  const KinematicPose world_pose = manipulator->getWorldKinematicPose();
+
+  // A slot is recomputed when it changed itself or its parent was recomputed in this pass
+  outdated_.assign(model.component.size(), 0);
+  KinematicPose pose;
+  for (uint8_t order = 0; order < traversal_order_.size(); order++)
+  {
+    const uint8_t index = traversal_order_[order];
+    const int16_t parent_index = model.parent_index[index];
+    outdated_[index] = manipulator->isComponentStateOutdatedUsingIndex(index) || (parent_index >= 0 && outdated_[parent_index]);
+    if (!outdated_[index])
+      continue;
+
+    const ComponentModel &component = model.component[index];
+    const KinematicPose &parent_pose = parent_index < 0 ?
+                                       world_pose :
+                                       manipulator->getComponentStateUsingIndex(parent_index).pose_from_world.kinematic;
+
+    pose.position.noalias() = parent_pose.orientation * component.relative.pose_from_parent.position;
+    pose.position += parent_pose.position;
+    pose.orientation.noalias() = parent_pose.orientation * component.relative.pose_from_parent.orientation;
+    if (index < model.tool_begin)
+    {
+      const double joint_position = manipulator->getComponentStateUsingIndex(index).joint_value.position;
+      pose.orientation = pose.orientation * exponentialRotation(component.joint_constant.axis, joint_position);
+    }
+    manipulator->setComponentKinematicPoseUsingIndex(index, pose);
+  }
+  manipulator->markForwardKinematicsSolved();
+
+  if (jacobian != nullptr && tool_index >= 0)
+    fillJacobian(manipulator, tool_index, jacobian);
+}
+
+void PoEKinematics::fillJacobian(Manipulator *manipulator, int16_t tool_index, Eigen::MatrixXd *jacobian)      //Private
+{
+  const ManipulatorModel &model = *model_;
+  jacobian->setZero(6, model.passive_joint_begin);
+
+  // Only the active joints between the world and the tool move it
+  const Eigen::Vector3d &tool_position = manipulator->getComponentStateUsingIndex(tool_index).pose_from_world.kinematic.position;
+  int16_t index = tool_index;
+  for (uint8_t depth = 0; index >= 0 && depth < model.component.size(); depth++, index = model.parent_index[index])
+  {
+    if (index >= model.passive_joint_begin)
+      continue;
+    const KinematicPose &joint_pose = manipulator->getComponentStateUsingIndex(index).pose_from_world.kinematic;
+    const Eigen::Vector3d axis = joint_pose.orientation * model.component[index].joint_constant.axis;
+    jacobian->block<3, 1>(0, index) = axis.cross(tool_position - joint_pose.position);
+    jacobian->block<3, 1>(3, index) = axis;
+  }
+}
+
+
+/*****************************************************************************
+** Damped Least Squares Kinematics
+*****************************************************************************/
+DampedLeastSquaresKinematics::DampedLeastSquaresKinematics()
+: last_iteration_(0)
+{
+  option_.iteration = 20;
+  option_.position_tolerance = 1E-6;
+  option_.orientation_tolerance = 1E-6;
+  option_.step_tolerance = 1E-12;
+  option_.max_damping = 0.1;
+  option_.manipulability_threshold = 1E-3;
+}
+
+void DampedLeastSquaresKinematics::setOption(const void *arg)
+{
+  if (arg == nullptr)
+  {
+    log::error("[DampedLeastSquaresKinematics] Option is nullptr.");
+    return;
+  }
+  option_ = *static_cast<const DampedLeastSquaresOption *>(arg);
+}
+
+bool DampedLeastSquaresKinematics::solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue>* goal_joint_position)
+{
+  last_iteration_ = 0;
+  int16_t tool_index = findToolIndex(manipulator, tool_name);
+  if (tool_index < 0)
+    return false;
+
+  // Reuses the storage of the previous solve
+  goal_manipulator_ = *manipulator;
+  const uint8_t dof = goal_manipulator_.getDOF();
+  const KinematicPose &tool_pose = goal_manipulator_.getComponentStateUsingIndex(tool_index).pose_from_world.kinematic;
+
+  Eigen::Matrix<double, 6, 1> pose_difference;
+  for (uint8_t count = 0; ; count++)
+  {
+    solveChain(&goal_manipulator_, tool_index, &jacobian_);
+    pose_difference.head<3>() = math::positionDifference<double>(target_pose.kinematic.position, tool_pose.position);
+    pose_difference.tail<3>() = math::orientationDifference<double>(target_pose.kinematic.orientation, tool_pose.orientation);
+    if (pose_difference.head<3>().norm() <= option_.position_tolerance &&
+        pose_difference.tail<3>().norm() <= option_.orientation_tolerance)
+    {
+      goal_joint_position->resize(dof);
+      for (uint8_t index = 0; index < dof; index++)
+        goal_joint_position->at(index) = goal_manipulator_.getComponentStateUsingIndex(index).joint_value;
+      return true;
+    }
+    if (count >= option_.iteration)
+      break;
+    last_iteration_ = count + 1;
+
+    // (J^T J + damping I) delta = J^T e. The damping is zero while the manipulability is above the threshold,
+    // and never more than the squared error so that it fades out near the target and keeps the last steps quadratic.
+    normal_matrix_.noalias() = jacobian_.transpose() * jacobian_;
+    normal_decomposition_.compute(normal_matrix_);
+    const double manipulability = std::sqrt(std::fabs(normal_decomposition_.vectorD().prod()));
+    if (manipulability < option_.manipulability_threshold)
+    {
+      const double ratio = manipulability / option_.manipulability_threshold;
+      const double damping = std::min(option_.max_damping * option_.max_damping, pose_difference.squaredNorm());
+      normal_matrix_.diagonal().array() += damping * (1.0 - ratio * ratio);
+      normal_decomposition_.compute(normal_matrix_);
+    }
+    gradient_.noalias() = jacobian_.transpose() * pose_difference;
+    delta_position_ = normal_decomposition_.solve(gradient_);
+
+    for (uint8_t index = 0; index < dof; index++)
+      goal_manipulator_.setJointPositionUsingIndex(index, goal_manipulator_.getComponentStateUsingIndex(index).joint_value.position + delta_position_(index));
+    if (delta_position_.norm() < option_.step_tolerance)
+      break;
+  }
+  log::error("[DampedLeastSquaresKinematics] Fail to solve inverse kinematics.");
+  return false;
+}
+
+const DampedLeastSquaresOption &DampedLeastSquaresKinematics::getOption() const
+{
+  return option_;
+}
+
+uint8_t DampedLeastSquaresKinematics::getLastIteration() const
+{
+  return last_iteration_;
+}
+
+
+/*****************************************************************************
+** Analytic Kinematics
+*****************************************************************************/
+AnalyticKinematics::AnalyticKinematics()
+: geometry_(ITERATIVE_GEOMETRY), geometry_revision_(0), geometry_tool_index_(-1)
+{
+  analytic_option_.geometry = AUTO_GEOMETRY;
+  analytic_option_.iterative = getOption();
+}
+
+void AnalyticKinematics::setOption(const void *arg)
+{
+  if (arg == nullptr)
+  {
+    log::error("[AnalyticKinematics] Option is nullptr.");
+    return;
+  }
+  analytic_option_ = *static_cast<const AnalyticKinematicsOption *>(arg);
+  DampedLeastSquaresKinematics::setOption(&analytic_option_.iterative);
+  geometry_revision_ = 0;
+}
+
+bool AnalyticKinematics::solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue>* goal_joint_position)
+{
+  int16_t tool_index = findToolIndex(manipulator, tool_name);
+  if (tool_index < 0)
+    return false;
+
+  if (updateGeometry(manipulator, tool_index))
+  {
+    // Branches inside the joint limits first, each group closest first
+    const ManipulatorModel &model = updateModel(manipulator);
+    const uint8_t dof = model.passive_joint_begin;
+    const uint8_t branch_size = solveBranch(manipulator, target_pose);
+    uint8_t rank[8];
+    bool in_limit[8];
+    double distance[8];
+    for (uint8_t branch = 0; branch < branch_size; branch++)
+    {
+      in_limit[branch] = true;
+      distance[branch] = 0.0;
+      for (uint8_t joint = 0; joint < dof; joint++)
+      {
+        const uint8_t index = joint_slot_[joint];
+        const Limit &limit = model.component[index].joint_constant.position_limit;
+        // The angle closest to the present position may be a turn away from the limits
+        double &position = branch_(joint, branch);
+        if (position > limit.maximum && position - 2.0 * M_PI >= limit.minimum)
+          position -= 2.0 * M_PI;
+        else if (position < limit.minimum && position + 2.0 * M_PI <= limit.maximum)
+          position += 2.0 * M_PI;
+        const double difference = position - manipulator->getComponentStateUsingIndex(index).joint_value.position;
+        in_limit[branch] = in_limit[branch] && position <= limit.maximum && position >= limit.minimum;
+        distance[branch] += difference * difference;
+      }
+
+      uint8_t order = branch;
+      for (; order > 0; order--)
+      {
+        const uint8_t other = rank[order - 1];
+        if (!((in_limit[branch] && !in_limit[other]) || (in_limit[branch] == in_limit[other] && distance[branch] < distance[other])))
+          break;
+        rank[order] = other;
+      }
+      rank[order] = branch;
+    }
+
+    // The next branch is tried when one fails the forward kinematics check
+    check_manipulator_ = *manipulator;
+    for (uint8_t order = 0; order < branch_size; order++)
+    {
+      if (checkBranch(tool_index, target_pose, rank[order]))
+      {
+        goal_joint_position->resize(dof);
+        for (uint8_t index = 0; index < dof; index++)
+          goal_joint_position->at(index) = check_manipulator_.getComponentStateUsingIndex(index).joint_value;
+        return true;
+      }
+    }
+  }
+  return DampedLeastSquaresKinematics::solveInverseKinematics(manipulator, tool_name, target_pose, goal_joint_position);
+}
+
+uint8_t AnalyticKinematics::solveAllInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointWaypoint> *goal_joint_position)
+{
+  goal_joint_position->clear();
+  int16_t tool_index = findToolIndex(manipulator, tool_name);
+  if (tool_index < 0 || !updateGeometry(manipulator, tool_index))
+    return 0;
+
+  const uint8_t dof = manipulator->getDOF();
+  const uint8_t branch_size = solveBranch(manipulator, target_pose);
+  std::vector<double> distance;
+  check_manipulator_ = *manipulator;
+  for (uint8_t branch = 0; branch < branch_size; branch++)
+  {
+    if (!checkBranch(tool_index, target_pose, branch))
+      continue;
+
+    double branch_distance = 0.0;
+    for (uint8_t joint = 0; joint < dof; joint++)
+    {
+      const double difference = branch_(joint, branch) - manipulator->getComponentStateUsingIndex(joint_slot_[joint]).joint_value.position;
+      branch_distance += difference * difference;
+    }
+    uint8_t order = 0;
+    while (order < distance.size() && distance.at(order) <= branch_distance)
+      order++;
+    distance.insert(distance.begin() + order, branch_distance);
+
+    JointWaypoint joint_way_point(dof);
+    for (uint8_t index = 0; index < dof; index++)
+      joint_way_point.at(index) = check_manipulator_.getComponentStateUsingIndex(index).joint_value;
+    goal_joint_position->insert(goal_joint_position->begin() + order, joint_way_point);
+  }
+  return goal_joint_position->size();
+}
+
+AnalyticGeometry AnalyticKinematics::getGeometry(Manipulator *manipulator, Name tool_name)
+{
+  int16_t tool_index = findToolIndex(manipulator, tool_name);
+  if (tool_index < 0 || !updateGeometry(manipulator, tool_index))
+    return ITERATIVE_GEOMETRY;
+  return geometry_;
+}
+
+bool AnalyticKinematics::updateGeometry(Manipulator *manipulator, int16_t tool_index)      //Private
+{
+  const ManipulatorModel &model = updateModel(manipulator);
+  if (geometry_revision_ == model.revision && geometry_tool_index_ == tool_index)
+    return geometry_ != ITERATIVE_GEOMETRY;
+  geometry_revision_ = model.revision;
+  geometry_tool_index_ = tool_index;
+  geometry_ = ITERATIVE_GEOMETRY;
+  if (analytic_option_.geometry == ITERATIVE_GEOMETRY)
+    return false;
+
+  // Every active joint between the world and the tool, and nothing else
+  const uint8_t dof = model.passive_joint_begin;
+  bool serial = (dof == 4 || dof == 6);
+  uint8_t chain_size = 0;
+  for (int16_t index = model.parent_index[tool_index]; serial && index >= 0; index = model.parent_index[index])
+  {
+    serial = index < dof && chain_size < dof;
+    if (serial)
+      joint_slot_[chain_size++] = index;
+  }
+  serial = serial && chain_size == dof;
+  std::reverse(joint_slot_, joint_slot_ + chain_size);
+
+  // Joint positions and axes at the zero configuration
+  Eigen::Vector3d position[6];
+  Eigen::Vector3d axis[6];
+  // Relative to the world pose, which moves without changing the model revision
+  KinematicPose world_pose;
+  world_pose.position = Eigen::Vector3d::Zero();
+  world_pose.orientation = Eigen::Matrix3d::Identity();
+  check_manipulator_ = *manipulator;
+  check_manipulator_.setWorldKinematicPose(world_pose);
+  for (uint8_t index = 0; index < dof; index++)
+    check_manipulator_.setJointPositionUsingIndex(index, 0.0);
+  solveChain(&check_manipulator_, -1, nullptr);
+  for (uint8_t joint = 0; serial && joint < dof; joint++)
+  {
+    const KinematicPose &pose = check_manipulator_.getComponentStateUsingIndex(joint_slot_[joint]).pose_from_world.kinematic;
+    position[joint] = pose.position;
+    axis[joint] = pose.orientation * model.component[joint_slot_[joint]].joint_constant.axis;
+    serial = axis[joint].norm() > 1E-6;
+    if (serial)
+      axis[joint].normalize();
+  }
+  const KinematicPose &tool_pose = check_manipulator_.getComponentStateUsingIndex(tool_index).pose_from_world.kinematic;
+  tool_orientation_ = tool_pose.orientation;
+
+  if (serial && dof == 4 && analytic_option_.geometry != SPHERICAL_WRIST_GEOMETRY)
+  {
+    if (setPlanarGeometry(position, axis, 3, tool_pose.position))
+      geometry_ = PLANAR_WRIST_GEOMETRY;
+  }
+  else if (serial && dof == 6 && analytic_option_.geometry != PLANAR_WRIST_GEOMETRY)
+  {
+    // Wrist center where the three wrist axes meet
+    const double tolerance = 1E-6;
+    const double cosine = axis[3].dot(axis[4]);
+    const Eigen::Vector3d difference = position[3] - position[4];
+    bool spherical = 1.0 - cosine * cosine > tolerance && axis[4].cross(axis[5]).norm() > tolerance;
+    Eigen::Vector3d wrist_center = Eigen::Vector3d::Zero();
+    if (spherical)
+    {
+      const double distance_3 = (cosine * axis[4].dot(difference) - axis[3].dot(difference)) / (1.0 - cosine * cosine);
+      const double distance_4 = (axis[4].dot(difference) - cosine * axis[3].dot(difference)) / (1.0 - cosine * cosine);
+      wrist_center = position[3] + distance_3 * axis[3];
+      const Eigen::Vector3d to_axis_5 = wrist_center - position[5];
+      spherical = (wrist_center - position[4] - distance_4 * axis[4]).norm() < tolerance &&
+                  (to_axis_5 - axis[5] * axis[5].dot(to_axis_5)).norm() < tolerance;
+    }
+    if (spherical && setPlanarGeometry(position, axis, 2, wrist_center))
+    {
+      wrist_axis_ << axis[3], axis[4], axis[5];
+      wrist_offset_ = tool_pose.position - wrist_center;
+      geometry_ = SPHERICAL_WRIST_GEOMETRY;
+    }
+  }
+
+  if (geometry_ == ITERATIVE_GEOMETRY && analytic_option_.geometry != AUTO_GEOMETRY)
+    log::warn("[AnalyticKinematics] The manipulator does not have the declared geometry, solving it iteratively.");
+  return geometry_ != ITERATIVE_GEOMETRY;
+}
+
+bool AnalyticKinematics::setPlanarGeometry(const Eigen::Vector3d *position, const Eigen::Vector3d *axis, uint8_t pitch_size, const Eigen::Vector3d &end)      //Private
+{
+  // Base axis z, pitch axes parallel to y, every joint and the end in the x-z plane through the base axis
+  const double tolerance = 1E-6;
+  const Eigen::Vector3d &z = axis[0];
+  const Eigen::Vector3d &y = axis[1];
+  if (std::fabs(y.dot(z)) > tolerance)
+    return false;
+  base_position_ = position[0];
+  base_frame_ << y.cross(z), y, z;
+
+  Eigen::Vector2d planar[4];
+  for (uint8_t pitch = 0; pitch <= pitch_size; pitch++)
+  {
+    const Eigen::Vector3d relative = (pitch < pitch_size ? position[pitch + 1] : end) - base_position_;
+    if (std::fabs(relative.dot(y)) > tolerance)
+      return false;
+    if (pitch < pitch_size)
+    {
+      if (axis[pitch + 1].cross(y).norm() > tolerance)
+        return false;
+      pitch_sign_[pitch] = axis[pitch + 1].dot(y) > 0.0 ? 1.0 : -1.0;
+    }
+    planar[pitch] << base_frame_.col(0).dot(relative), z.dot(relative);
+  }
+
+  shoulder_ = planar[0];
+  for (uint8_t link = 0; link < pitch_size; link++)
+  {
+    const Eigen::Vector2d vector = planar[link + 1] - planar[link];
+    link_length_[link] = vector.norm();
+    link_angle_[link] = std::atan2(vector(1), vector(0));
+  }
+  return link_length_[0] > tolerance && link_length_[1] > tolerance;
+}
+
+uint8_t AnalyticKinematics::solveBranch(Manipulator *manipulator, const Pose &target_pose)      //Private
+{
+  // The geometry is relative to the world pose, so is the target
+  const KinematicPose world_pose = manipulator->getWorldKinematicPose();
+  const Eigen::Matrix3d target_orientation = world_pose.orientation.transpose() * target_pose.kinematic.orientation;
+  const Eigen::Matrix3d orientation_change = target_orientation * tool_orientation_.transpose();
+  Eigen::Vector3d end = world_pose.orientation.transpose() * (target_pose.kinematic.position - world_pose.position);
+
+  // A rotation by angle about y turns the planar angle of a link by -angle
+  if (geometry_ == SPHERICAL_WRIST_GEOMETRY)
+    end -= orientation_change * wrist_offset_;
+  const Eigen::Vector3d relative = base_frame_.transpose() * (end - base_position_);
+  const Eigen::Matrix3d planar_orientation = base_frame_.transpose() * orientation_change * base_frame_;
+
+  uint8_t branch_size = 0;
+  for (uint8_t yaw_branch = 0; yaw_branch < 2; yaw_branch++)
+  {
+    const double yaw = std::atan2(relative(1), relative(0)) + yaw_branch * M_PI;
+    Eigen::Vector2d point(std::cos(yaw) * relative(0) + std::sin(yaw) * relative(1), relative(2));
+    Eigen::Matrix3d base_rotation;
+    if (geometry_ == SPHERICAL_WRIST_GEOMETRY)
+      base_rotation = exponentialRotation(base_frame_.col(2), yaw);
+
+    double pitch_sum = 0.0;
+    if (geometry_ == PLANAR_WRIST_GEOMETRY)
+    {
+      pitch_sum = std::atan2(std::cos(yaw) * planar_orientation(0, 2) + std::sin(yaw) * planar_orientation(1, 2),
+                             std::cos(yaw) * planar_orientation(0, 0) + std::sin(yaw) * planar_orientation(1, 0));
+      point -= link_length_[2] * Eigen::Vector2d(std::cos(link_angle_[2] - pitch_sum), std::sin(link_angle_[2] - pitch_sum));
+    }
+
+    // Two links from the shoulder to the point
+    const Eigen::Vector2d difference = point - shoulder_;
+    double cosine = (difference.squaredNorm() - link_length_[0] * link_length_[0] - link_length_[1] * link_length_[1]) /
+                    (2.0 * link_length_[0] * link_length_[1]);
+    if (std::fabs(cosine) > 1.0 + 1E-9)
+      continue;
+    cosine = std::max(-1.0, std::min(1.0, cosine));
+
+    for (uint8_t elbow_branch = 0; elbow_branch < 2; elbow_branch++)
+    {
+      const double elbow = elbow_branch == 0 ? std::acos(cosine) : -std::acos(cosine);
+      const double shoulder = std::atan2(difference(1), difference(0)) -
+                              std::atan2(link_length_[1] * std::sin(elbow), link_length_[0] + link_length_[1] * std::cos(elbow));
+      const double joint_2 = pitch_sign_[0] * (link_angle_[0] - shoulder);
+      const double joint_3 = pitch_sign_[1] * (link_angle_[1] - link_angle_[0] - elbow);
+
+      if (geometry_ == PLANAR_WRIST_GEOMETRY)
+      {
+        branch_.col(branch_size) << yaw, joint_2, joint_3, pitch_sign_[2] * (pitch_sum - pitch_sign_[0] * joint_2 - pitch_sign_[1] * joint_3), 0.0, 0.0;
+        branch_size++;
+        continue;
+      }
+
+      // Spherical wrist: rotation left for the wrist, first two wrist angles bring the last axis in place.
+      // The pitch axes are parallel, so the arm rotation is the base rotation and one pitch rotation.
+      const Eigen::Matrix3d wrist_orientation = (base_rotation *
+                                                 exponentialRotation(base_frame_.col(1), pitch_sign_[0] * joint_2 + pitch_sign_[1] * joint_3)).transpose() * orientation_change;
+      // At the wrist singularity the first wrist joint keeps its position
+      double joint_4[2], joint_5[2];
+      const uint8_t wrist_size = rotationAngle(wrist_axis_.col(0), wrist_axis_.col(1), wrist_axis_.col(2),
+                                               wrist_orientation * wrist_axis_.col(2), joint_4, joint_5,
+                                               manipulator->getComponentStateUsingIndex(joint_slot_[3]).joint_value.position);
+      const Eigen::Vector3d last_axis_target = wrist_orientation * wrist_axis_.col(1);
+      for (uint8_t wrist_branch = 0; wrist_branch < wrist_size; wrist_branch++)
+      {
+        const Eigen::Vector3d rest = rotateVector(wrist_axis_.col(1), -joint_5[wrist_branch],
+                                                  rotateVector(wrist_axis_.col(0), -joint_4[wrist_branch], last_axis_target));
+        const double joint_6 = rotationAngle(wrist_axis_.col(2), wrist_axis_.col(1), rest);
+        branch_.col(branch_size) << yaw, joint_2, joint_3, joint_4[wrist_branch], joint_5[wrist_branch], joint_6;
+        branch_size++;
+      }
+    }
+  }
+
+  // Each angle closest to the present joint position
+  const uint8_t dof = geometry_ == PLANAR_WRIST_GEOMETRY ? 4 : 6;
+  for (uint8_t branch = 0; branch < branch_size; branch++)
+  {
+    for (uint8_t joint = 0; joint < dof; joint++)
+    {
+      const double present = manipulator->getComponentStateUsingIndex(joint_slot_[joint]).joint_value.position;
+      branch_(joint, branch) = present + wrapAngle(branch_(joint, branch) - present);
+    }
+  }
+  return branch_size;
+}
+
+bool AnalyticKinematics::checkBranch(int16_t tool_index, const Pose &target_pose, uint8_t branch)      //Private
+{
+  const uint8_t dof = check_manipulator_.getDOF();
+  for (uint8_t joint = 0; joint < dof; joint++)
+    check_manipulator_.setJointPositionUsingIndex(joint_slot_[joint], branch_(joint, branch));
+  solveChain(&check_manipulator_, -1, nullptr);
+
+  const KinematicPose &tool_pose = check_manipulator_.getComponentStateUsingIndex(tool_index).pose_from_world.kinematic;
+  return math::positionDifference<double>(target_pose.kinematic.position, tool_pose.position).norm() <= getOption().position_tolerance &&
+         math::orientationDifference<double>(target_pose.kinematic.orientation, tool_pose.orientation).norm() <= getOption().orientation_tolerance;
+}
+
+
+/*****************************************************************************
+** Cached Kinematics
+*****************************************************************************/
+size_t CachedKinematics::KeyHash::operator()(const Key &key) const
+{
+  size_t hash = std::hash<Name>()(key.tool_name);
+  for (uint8_t index = 0; index < key.cell.size(); index++)
+    hash ^= std::hash<int64_t>()(key.cell[index]) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  return hash;
+}
+
+CachedKinematics::CachedKinematics(Kinematics *kinematics)
+  : kinematics_(kinematics), revision_(0), hit_count_(0), miss_count_(0)
+{
+  option_.capacity = 1024;
+  option_.position_resolution = 1E-6;
+  option_.orientation_resolution = 1E-6;
+  option_.seed_resolution = 0.1;
+  option_.position_tolerance = 1E-5;
+  option_.orientation_tolerance = 1E-5;
+}
+
+void CachedKinematics::setOption(const void *arg)
+{
+  clearCache();
+  kinematics_->setOption(arg);
+}
+
+Eigen::MatrixXd CachedKinematics::jacobian(Manipulator *manipulator, Name tool_name)
+{
+  return kinematics_->jacobian(manipulator, tool_name);
+}
+
+void CachedKinematics::solveForwardKinematics(Manipulator *manipulator)
+{
+  kinematics_->solveForwardKinematics(manipulator);
+}
+
+bool CachedKinematics::isPositionOnly() const
+{
+  return kinematics_->isPositionOnly();
+}
+
+bool CachedKinematics::solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue>* goal_joint_position)
+{
+  if (manipulator->getModelRevision() != revision_)
+  {
+    clearCache();
+    revision_ = manipulator->getModelRevision();
+  }
+
+  makeKey(manipulator, tool_name, target_pose);
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash>::iterator it = index_.find(key_);
+  if (it != index_.end())
+  {
+    hit_count_++;
+    entry_.splice(entry_.begin(), entry_, it->second);
+    const std::vector<double> &joint_position = it->second->joint_position;
+    goal_joint_position->resize(joint_position.size());
+    for (uint8_t index = 0; index < joint_position.size(); index++)
+    {
+      goal_joint_position->at(index) = manipulator->getComponentStateUsingIndex(index).joint_value;
+      goal_joint_position->at(index).position = joint_position[index];
+    }
+    return true;
+  }
+
+  miss_count_++;
+  if (!kinematics_->solveInverseKinematics(manipulator, tool_name, target_pose, goal_joint_position))
+    return false;
+  if (option_.capacity == 0)
+    return true;
+  if (!checkSolution(manipulator, tool_name, target_pose, *goal_joint_position))
+  {
+    log::warn("[CachedKinematics] The solution does not reach the target, it is not stored.");
+    return true;
+  }
+
+  if (entry_.size() >= option_.capacity)
+  {
+    index_.erase(entry_.back().key);
+    entry_.pop_back();
+  }
+  entry_.push_front(Entry());
+  entry_.front().key = key_;
+  entry_.front().joint_position.resize(goal_joint_position->size());
+  for (uint8_t index = 0; index < goal_joint_position->size(); index++)
+    entry_.front().joint_position[index] = goal_joint_position->at(index).position;
+  index_[key_] = entry_.begin();
+  return true;
+}
+
+void CachedKinematics::setCacheOption(const KinematicsCacheOption &option)
+{
+  option_ = option;
+  clearCache();
+}
+
+const KinematicsCacheOption &CachedKinematics::getCacheOption() const
+{
+  return option_;
+}
+
+void CachedKinematics::clearCache()
+{
+  entry_.clear();
+  index_.clear();
+}
+
+size_t CachedKinematics::getCacheSize() const
+{
+  return entry_.size();
+}
+
+uint32_t CachedKinematics::getHitCount() const
+{
+  return hit_count_;
+}
+
+uint32_t CachedKinematics::getMissCount() const
+{
+  return miss_count_;
+}
+
+void CachedKinematics::makeKey(Manipulator *manipulator, Name tool_name, const Pose &target_pose)      //Private
+{
+  // The world pose moves without changing the model revision, so it is part of the key
+  const uint8_t dof = manipulator->getDOF();
+  const KinematicPose world_pose = manipulator->getWorldKinematicPose();
+  key_.tool_name = tool_name;
+  key_.cell.resize(24 + dof);
+  for (uint8_t index = 0; index < 3; index++)
+  {
+    key_.cell[index] = std::llround(target_pose.kinematic.position(index) / option_.position_resolution);
+    key_.cell[12 + index] = std::llround(world_pose.position(index) / option_.position_resolution);
+  }
+  for (uint8_t index = 0; index < 9; index++)
+  {
+    key_.cell[3 + index] = std::llround(target_pose.kinematic.orientation(index) / option_.orientation_resolution);
+    key_.cell[15 + index] = std::llround(world_pose.orientation(index) / option_.orientation_resolution);
+  }
+  for (uint8_t index = 0; index < dof; index++)
+    key_.cell[24 + index] = std::llround(manipulator->getComponentStateUsingIndex(index).joint_value.position / option_.seed_resolution);
+}
+
+bool CachedKinematics::checkSolution(Manipulator *manipulator, Name tool_name, const Pose &target_pose, const std::vector<JointValue> &goal_joint_position)      //Private
+{
+  check_manipulator_ = *manipulator;
+  for (uint8_t index = 0; index < goal_joint_position.size(); index++)
+    check_manipulator_.setJointPositionUsingIndex(index, goal_joint_position.at(index).position);
+  kinematics_->solveForwardKinematics(&check_manipulator_);
+
+  return math::positionDifference<double>(target_pose.kinematic.position, check_manipulator_.getComponentPositionFromWorld(tool_name)).norm() <= option_.position_tolerance &&
+         math::orientationDifference<double>(target_pose.kinematic.orientation, check_manipulator_.getComponentOrientationFromWorld(tool_name)).norm() <= option_.orientation_tolerance;
+}
+
+
+#if !defined(__OPENCR__)
+/*****************************************************************************
+** Batch Inverse Kinematics
+*****************************************************************************/
+BatchKinematics::BatchKinematics(KinematicsFactory factory, uint8_t thread_size)
+  : batch_(0), running_size_(0), stop_(false), manipulator_(nullptr), target_pose_(nullptr), result_(nullptr)
+{
+  if (thread_size == 0)
+    thread_size = std::max(1u, std::min(255u, std::thread::hardware_concurrency()));
+
+  for (uint8_t thread = 0; thread < thread_size; thread++)
+  {
+    worker_.push_back(std::unique_ptr<Worker>(new Worker));
+    worker_.back()->kinematics.reset(factory ? factory() : nullptr);
+    worker_.back()->begin = 0;
+    worker_.back()->end = 0;
+  }
+  if (!worker_.front()->kinematics)
+    log::error("[BatchKinematics] Factory does not make a solver.");
+
+  // The calling thread is worker 0
+  for (uint8_t thread = 1; thread < thread_size; thread++)
+    worker_.at(thread)->thread = std::thread(&BatchKinematics::run, this, thread);
+}
+
+BatchKinematics::~BatchKinematics()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_condition_.notify_all();
+  for (uint8_t thread = 1; thread < worker_.size(); thread++)
+    worker_.at(thread)->thread.join();
+}
+
+void BatchKinematics::setOption(const void *arg)
+{
+  for (uint8_t thread = 0; thread < worker_.size(); thread++)
+  {
+    if (worker_.at(thread)->kinematics)
+      worker_.at(thread)->kinematics->setOption(arg);
+  }
+}
+
+bool BatchKinematics::solveInverseKinematics(const Manipulator &manipulator, Name tool_name, const Pose *target_pose, size_t target_size,
+                                             std::vector<InverseKinematicsResult> *result)
+{
+  for (uint8_t thread = 0; thread < worker_.size(); thread++)
+  {
+    if (!worker_.at(thread)->kinematics)
+    {
+      log::error("[BatchKinematics] There is no solver.");
+      return false;
+    }
+  }
+  result->resize(target_size);
+  if (target_size == 0)
+    return true;
+
+  manipulator_ = &manipulator;
+  tool_name_ = tool_name;
+  target_pose_ = target_pose;
+  result_ = result;
+  for (uint8_t thread = 0; thread < worker_.size(); thread++)
+  {
+    std::lock_guard<std::mutex> lock(worker_.at(thread)->mutex);
+    worker_.at(thread)->begin = target_size * thread / worker_.size();
+    worker_.at(thread)->end = target_size * (thread + 1) / worker_.size();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_size_ = worker_.size() - 1;
+    batch_++;
+  }
+  start_condition_.notify_all();
+  solveBatch(0);
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_condition_.wait(lock, [this]{ return running_size_ == 0; });
+  }
+
+  bool solved = true;
+  for (size_t index = 0; index < target_size; index++)
+    solved = solved && result->at(index).solved;
+  return solved;
+}
+
+bool BatchKinematics::solveInverseKinematics(const Manipulator &manipulator, Name tool_name, const std::vector<Pose> &target_pose,
+                                             std::vector<InverseKinematicsResult> *result)
+{
+  return solveInverseKinematics(manipulator, tool_name, target_pose.data(), target_pose.size(), result);
+}
+
+uint8_t BatchKinematics::getThreadSize() const
+{
+  return worker_.size();
+}
+
+void BatchKinematics::run(uint8_t thread)      //Private
+{
+  uint32_t batch = 0;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_condition_.wait(lock, [this, batch]{ return stop_ || batch_ != batch; });
+      if (stop_)
+        return;
+      batch = batch_;
+    }
+    solveBatch(thread);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_size_--;
+      if (running_size_ == 0)
+        done_condition_.notify_one();
+    }
+  }
+}
+
+void BatchKinematics::solveBatch(uint8_t thread)      //Private
+{
+  Worker &worker = *worker_.at(thread);
+
+  size_t target;
+  while (takeTarget(thread, &target))
+  {
+    // A solver may leave its own state in the manipulator, every target starts from a fresh copy
+    worker.manipulator = *manipulator_;
+    InverseKinematicsResult &result = result_->at(target);
+    // Nothing of a previous batch is left behind when a solver fails without writing the result
+    result.goal_joint_position.clear();
+    result.solved = worker.kinematics->solveInverseKinematics(&worker.manipulator, tool_name_, target_pose_[target], &result.goal_joint_position);
+  }
+}
+
+bool BatchKinematics::takeTarget(uint8_t thread, size_t *target)      //Private
+{
+  Worker &worker = *worker_.at(thread);
+  {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.begin < worker.end)
+    {
+      *target = worker.begin++;
+      return true;
+    }
+  }
+
+  // Steals half of the remaining targets of the next thread that has some
+  for (uint8_t offset = 1; offset < worker_.size(); offset++)
+  {
+    Worker &victim = *worker_.at((thread + offset) % worker_.size());
+    size_t begin, end;
+    {
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (victim.begin >= victim.end)
+        continue;
+      end = victim.end;
+      begin = victim.end - (victim.end - victim.begin + 1) / 2;
+      victim.end = begin;
+    }
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    *target = begin;
+    worker.begin = begin + 1;
+    worker.end = end;
+    return true;
+  }
+  return false;
+}
+#endif
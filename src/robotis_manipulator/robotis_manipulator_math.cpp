@@ -64,52 +64,27 @@ Eigen::Vector3d robotis_manipulator::math::convertXYZToVector(double x, double y
 //Rotation
 Eigen::Matrix3d robotis_manipulator::math::convertRollAngleToRotationMatrix(double angle)
 {
-  Eigen::Matrix3d rotation(3,3);
-  rotation <<
-      1.0, 0.0, 0.0,
-      0.0, cos(angle), -sin(angle),
-      0.0, sin(angle), cos(angle);
-
-  return rotation;
+  return convertRollAngleToRotationMatrix<double>(angle);
 }
 
 Eigen::Matrix3d robotis_manipulator::math::convertPitchAngleToRotationMatrix(double angle)
 {
-  Eigen::Matrix3d rotation(3,3);
-  rotation <<
-      cos(angle), 0.0, sin(angle),
-      0.0, 1.0, 0.0,
-      -sin(angle), 0.0, cos(angle);
-
-  return rotation;
+  return convertPitchAngleToRotationMatrix<double>(angle);
 }
 
 Eigen::Matrix3d robotis_manipulator::math::convertYawAngleToRotationMatrix(double angle)
 {
-  Eigen::Matrix3d rotation(3,3);
-  rotation <<
-      cos(angle), -sin(angle), 0.0,
-      sin(angle), cos(angle), 0.0,
-      0.0, 0.0, 1.0;
-
-  return rotation;
+  return convertYawAngleToRotationMatrix<double>(angle);
 }
 
 Eigen::Vector3d robotis_manipulator::math::convertRotationMatrixToRPYVector(const Eigen::Matrix3d& rotation)
 {
-  Eigen::Vector3d rpy;// = Eigen::MatrixXd::Zero(3,1);
-  rpy.coeffRef(0,0) = atan2(rotation.coeff(2,1), rotation.coeff(2,2));
-  rpy.coeffRef(1,0) = atan2(-rotation.coeff(2,0), sqrt(pow(rotation.coeff(2,1), 2) + pow(rotation.coeff(2,2),2)));
-  rpy.coeffRef(2,0) = atan2 (rotation.coeff(1,0), rotation.coeff(0,0));
-
-  return rpy;
+  return convertRotationMatrixToRPYVector<double>(rotation);
 }
 
 Eigen::Matrix3d robotis_manipulator::math::convertRPYToRotationMatrix(double roll, double pitch, double yaw)
 {
-  Eigen::Matrix3d rotation = robotis_manipulator::math::convertYawAngleToRotationMatrix(yaw)*robotis_manipulator::math::convertPitchAngleToRotationMatrix(pitch)*robotis_manipulator::math::convertRollAngleToRotationMatrix(roll);
-
-  return rotation;
+  return convertRPYToRotationMatrix<double>(roll, pitch, yaw);
 }
 
 Eigen::Quaterniond robotis_manipulator::math::convertRPYToQuaternion(double roll, double pitch, double yaw)
@@ -232,64 +207,22 @@ Eigen::Matrix4d robotis_manipulator::math::inverseTransformationMatrix(const Eig
 //Dynamic value
 Eigen::Vector3d robotis_manipulator::math::convertOmegaToRPYVelocity(Eigen::Vector3d rpy_vector, Eigen::Vector3d omega)
 {
-  Eigen::Matrix3d c_inverse;
-  Eigen::Vector3d rpy_velocity;
-
-  c_inverse << 1, sin(rpy_vector(0))*tan(rpy_vector(1)), cos(rpy_vector(0))*tan(rpy_vector(1)),
-       0, cos(rpy_vector(0)),                    -sin(rpy_vector(0)),
-       0, sin(rpy_vector(0))/cos(rpy_vector(1)), cos(rpy_vector(0))/cos(rpy_vector(1));
-
-  rpy_velocity = c_inverse * omega;
-  return rpy_velocity;
+  return convertOmegaToRPYVelocity<double>(rpy_vector, omega);
 }
 
 Eigen::Vector3d robotis_manipulator::math::convertRPYVelocityToOmega(Eigen::Vector3d rpy_vector, Eigen::Vector3d rpy_velocity)
 {
-  Eigen::Matrix3d c;
-  Eigen::Vector3d omega;
-
-  c << 1, 0,                     -sin(rpy_vector(1)),
-        0, cos(rpy_vector(0)),    sin(rpy_vector(0))*cos(rpy_vector(1)),
-        0, -sin(rpy_vector(0)), cos(rpy_vector(0))*cos(rpy_vector(1));
-
-  omega = c * rpy_velocity;
-  return omega;
+  return convertRPYVelocityToOmega<double>(rpy_vector, rpy_velocity);
 }
 
 Eigen::Vector3d robotis_manipulator::math::convertOmegaDotToRPYAcceleration(Eigen::Vector3d rpy_vector, Eigen::Vector3d rpy_velocity, Eigen::Vector3d omega_dot)
 {
-  Eigen::Vector3d c_dot;
-  Eigen::Matrix3d c_inverse;
-  Eigen::Vector3d rpy_acceleration;
-
-  c_dot << -cos(rpy_vector[1]) * rpy_velocity[1] * rpy_velocity[2],
-           -sin(rpy_vector[0]) * rpy_velocity[0] * rpy_velocity[1] - sin(rpy_vector[0]) * sin(rpy_vector[1]) * rpy_velocity[1] * rpy_velocity[2] + cos(rpy_vector[0]) * cos(rpy_vector[1]) * rpy_velocity[0] * rpy_velocity[2],
-           -cos(rpy_vector[0]) * rpy_velocity[0] * rpy_velocity[1] - sin(rpy_vector[0]) * cos(rpy_vector[1]) * rpy_velocity[0] * rpy_velocity[2] - cos(rpy_vector[0]) * sin(rpy_vector[1]) * rpy_velocity[1] * rpy_velocity[2];
-
-  c_inverse << 1, sin(rpy_vector(0))*tan(rpy_vector(1)), cos(rpy_vector(0))*tan(rpy_vector(1)),
-       0, cos(rpy_vector(0)),                    -sin(rpy_vector(0)),
-       0, sin(rpy_vector(0))/cos(rpy_vector(1)), cos(rpy_vector(0))/cos(rpy_vector(1));
-
-  rpy_acceleration = c_inverse * (omega_dot - c_dot);
-  return rpy_acceleration;
+  return convertOmegaDotToRPYAcceleration<double>(rpy_vector, rpy_velocity, omega_dot);
 }
 
 Eigen::Vector3d robotis_manipulator::math::convertRPYAccelerationToOmegaDot(Eigen::Vector3d rpy_vector, Eigen::Vector3d rpy_velocity, Eigen::Vector3d rpy_acceleration)
 {
-  Eigen::Vector3d c_dot;
-  Eigen::Matrix3d c;
-  Eigen::Vector3d omega_dot;
-
-  c_dot << -cos(rpy_vector[1]) * rpy_velocity[1] * rpy_velocity[2],
-           -sin(rpy_vector[0]) * rpy_velocity[0] * rpy_velocity[1] - sin(rpy_vector[0]) * sin(rpy_vector[1]) * rpy_velocity[1] * rpy_velocity[2] + cos(rpy_vector[0]) * cos(rpy_vector[1]) * rpy_velocity[0] * rpy_velocity[2],
-           -cos(rpy_vector[0]) * rpy_velocity[0] * rpy_velocity[1] - sin(rpy_vector[0]) * cos(rpy_vector[1]) * rpy_velocity[0] * rpy_velocity[2] - cos(rpy_vector[0]) * sin(rpy_vector[1]) * rpy_velocity[1] * rpy_velocity[2];
-
-  c << 1, 0,                     -sin(rpy_vector(1)),
-        0, cos(rpy_vector(0)),    sin(rpy_vector(0))*cos(rpy_vector(1)),
-        0, -sin(rpy_vector(0)), cos(rpy_vector(0))*cos(rpy_vector(1));
-
-  omega_dot = c_dot + c * rpy_acceleration;
-  return omega_dot;
+  return convertRPYAccelerationToOmegaDot<double>(rpy_vector, rpy_velocity, rpy_acceleration);
 }
 
 
@@ -310,74 +243,27 @@ double robotis_manipulator::math::sign(double value)
 
 Eigen::Vector3d robotis_manipulator::math::matrixLogarithm(Eigen::Matrix3d rotation_matrix)
 {
-  Eigen::Matrix3d R = rotation_matrix;
-  Eigen::Vector3d l = Eigen::Vector3d::Zero();
-  Eigen::Vector3d rotation_vector = Eigen::Vector3d::Zero();
-
-  double theta = 0.0;
-  // double diag = 0.0;
-  bool diagonal_matrix = R.isDiagonal();
-
-  l << R(2, 1) - R(1, 2),
-      R(0, 2) - R(2, 0),
-      R(1, 0) - R(0, 1);
-  theta = atan2(l.norm(), R(0, 0) + R(1, 1) + R(2, 2) - 1);
-  // diag = R.determinant();
-
-  if (R.isIdentity())
-  {
-    rotation_vector.setZero(3);
-    return rotation_vector;
-  }
-  
-  if (diagonal_matrix == true)
-  {
-    rotation_vector << R(0, 0) + 1, R(1, 1) + 1, R(2, 2) + 1;
-    rotation_vector = rotation_vector * M_PI_2;
-  }
-  else
-  {
-    rotation_vector = theta * (l / l.norm());
-  }
-  return rotation_vector;
+  return matrixLogarithm<double>(rotation_matrix);
 }
 
 Eigen::Matrix3d robotis_manipulator::math::skewSymmetricMatrix(Eigen::Vector3d v)
 {
-  Eigen::Matrix3d skew_symmetric_matrix = Eigen::Matrix3d::Zero();
-  skew_symmetric_matrix << 0, -v(2), v(1),
-      v(2), 0, -v(0),
-      -v(1), v(0), 0;
-  return skew_symmetric_matrix;
+  return skewSymmetricMatrix<double>(v);
 }
 
 Eigen::Matrix3d robotis_manipulator::math::rodriguesRotationMatrix(Eigen::Vector3d axis, double angle)
 {
-  Eigen::Matrix3d skew_symmetric_matrix = Eigen::Matrix3d::Zero();
-  Eigen::Matrix3d rotation_matrix = Eigen::Matrix3d::Zero();
-  Eigen::Matrix3d Identity_matrix = Eigen::Matrix3d::Identity();
-
-  skew_symmetric_matrix = robotis_manipulator::math::skewSymmetricMatrix(axis);
-  rotation_matrix = Identity_matrix +
-                    skew_symmetric_matrix * sin(angle) +
-                    skew_symmetric_matrix * skew_symmetric_matrix * (1 - cos(angle));
-  return rotation_matrix;
+  return rodriguesRotationMatrix<double>(axis, angle);
 }
 
 Eigen::Vector3d robotis_manipulator::math::positionDifference(Eigen::Vector3d desired_position, Eigen::Vector3d present_position)
 {
-  Eigen::Vector3d position_difference;
-  position_difference = desired_position - present_position;
-
-  return position_difference;
+  return positionDifference<double>(desired_position, present_position);
 }
 
 Eigen::Vector3d robotis_manipulator::math::orientationDifference(Eigen::Matrix3d desired_orientation, Eigen::Matrix3d present_orientation)
 {
-  Eigen::Vector3d orientation_difference;
-  orientation_difference = present_orientation * robotis_manipulator::math::matrixLogarithm(present_orientation.transpose() * desired_orientation);
-
-  return orientation_difference;
+  return orientationDifference<double>(desired_orientation, present_orientation);
 }
 
 Eigen::VectorXd robotis_manipulator::math::poseDifference(Eigen::Vector3d desired_position, Eigen::Vector3d present_position,
@@ -405,3 +291,196 @@ Eigen::VectorXd robotis_manipulator::math::dynamicPoseDifference(Eigen::Vector3d
 
   return dynamic_pose_difference;
 }
+
+
+/*****************************************************************************
+** Scalar Templates
+*****************************************************************************/
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> robotis_manipulator::math::convertRollAngleToRotationMatrix(typename Eigen::NumTraits<Scalar>::Real angle)
+{
+  Eigen::Matrix<Scalar, 3, 3> rotation;
+  rotation <<
+      1.0, 0.0, 0.0,
+      0.0, std::cos(angle), -std::sin(angle),
+      0.0, std::sin(angle), std::cos(angle);
+
+  return rotation;
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> robotis_manipulator::math::convertPitchAngleToRotationMatrix(typename Eigen::NumTraits<Scalar>::Real angle)
+{
+  Eigen::Matrix<Scalar, 3, 3> rotation;
+  rotation <<
+      std::cos(angle), 0.0, std::sin(angle),
+      0.0, 1.0, 0.0,
+      -std::sin(angle), 0.0, std::cos(angle);
+
+  return rotation;
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> robotis_manipulator::math::convertYawAngleToRotationMatrix(typename Eigen::NumTraits<Scalar>::Real angle)
+{
+  Eigen::Matrix<Scalar, 3, 3> rotation;
+  rotation <<
+      std::cos(angle), -std::sin(angle), 0.0,
+      std::sin(angle), std::cos(angle), 0.0,
+      0.0, 0.0, 1.0;
+
+  return rotation;
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::convertRotationMatrixToRPYVector(const Eigen::Matrix<Scalar, 3, 3>& rotation)
+{
+  Eigen::Matrix<Scalar, 3, 1> rpy;
+  rpy.coeffRef(0,0) = std::atan2(rotation.coeff(2,1), rotation.coeff(2,2));
+  rpy.coeffRef(1,0) = std::atan2(-rotation.coeff(2,0), std::sqrt(rotation.coeff(2,1) * rotation.coeff(2,1) + rotation.coeff(2,2) * rotation.coeff(2,2)));
+  rpy.coeffRef(2,0) = std::atan2(rotation.coeff(1,0), rotation.coeff(0,0));
+
+  return rpy;
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> robotis_manipulator::math::convertRPYToRotationMatrix(typename Eigen::NumTraits<Scalar>::Real roll,
+                                                                                 typename Eigen::NumTraits<Scalar>::Real pitch,
+                                                                                 typename Eigen::NumTraits<Scalar>::Real yaw)
+{
+  return convertYawAngleToRotationMatrix<Scalar>(yaw) * convertPitchAngleToRotationMatrix<Scalar>(pitch) * convertRollAngleToRotationMatrix<Scalar>(roll);
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::convertOmegaToRPYVelocity(const Eigen::Matrix<Scalar, 3, 1>& rpy_vector, const Eigen::Matrix<Scalar, 3, 1>& omega)
+{
+  Eigen::Matrix<Scalar, 3, 3> c_inverse;
+
+  c_inverse << 1.0, std::sin(rpy_vector(0))*std::tan(rpy_vector(1)), std::cos(rpy_vector(0))*std::tan(rpy_vector(1)),
+       0.0, std::cos(rpy_vector(0)),                         -std::sin(rpy_vector(0)),
+       0.0, std::sin(rpy_vector(0))/std::cos(rpy_vector(1)), std::cos(rpy_vector(0))/std::cos(rpy_vector(1));
+
+  return c_inverse * omega;
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::convertRPYVelocityToOmega(const Eigen::Matrix<Scalar, 3, 1>& rpy_vector, const Eigen::Matrix<Scalar, 3, 1>& rpy_velocity)
+{
+  Eigen::Matrix<Scalar, 3, 3> c;
+
+  c << 1.0, 0.0,                      -std::sin(rpy_vector(1)),
+        0.0, std::cos(rpy_vector(0)),  std::sin(rpy_vector(0))*std::cos(rpy_vector(1)),
+        0.0, -std::sin(rpy_vector(0)), std::cos(rpy_vector(0))*std::cos(rpy_vector(1));
+
+  return c * rpy_velocity;
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::convertOmegaDotToRPYAcceleration(const Eigen::Matrix<Scalar, 3, 1>& rpy_vector, const Eigen::Matrix<Scalar, 3, 1>& rpy_velocity,
+                                                                                       const Eigen::Matrix<Scalar, 3, 1>& omega_dot)
+{
+  Eigen::Matrix<Scalar, 3, 1> c_dot;
+  Eigen::Matrix<Scalar, 3, 3> c_inverse;
+
+  c_dot << -std::cos(rpy_vector[1]) * rpy_velocity[1] * rpy_velocity[2],
+           -std::sin(rpy_vector[0]) * rpy_velocity[0] * rpy_velocity[1] - std::sin(rpy_vector[0]) * std::sin(rpy_vector[1]) * rpy_velocity[1] * rpy_velocity[2] + std::cos(rpy_vector[0]) * std::cos(rpy_vector[1]) * rpy_velocity[0] * rpy_velocity[2],
+           -std::cos(rpy_vector[0]) * rpy_velocity[0] * rpy_velocity[1] - std::sin(rpy_vector[0]) * std::cos(rpy_vector[1]) * rpy_velocity[0] * rpy_velocity[2] - std::cos(rpy_vector[0]) * std::sin(rpy_vector[1]) * rpy_velocity[1] * rpy_velocity[2];
+
+  c_inverse << 1.0, std::sin(rpy_vector(0))*std::tan(rpy_vector(1)), std::cos(rpy_vector(0))*std::tan(rpy_vector(1)),
+       0.0, std::cos(rpy_vector(0)),                         -std::sin(rpy_vector(0)),
+       0.0, std::sin(rpy_vector(0))/std::cos(rpy_vector(1)), std::cos(rpy_vector(0))/std::cos(rpy_vector(1));
+
+  return c_inverse * (omega_dot - c_dot);
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::convertRPYAccelerationToOmegaDot(const Eigen::Matrix<Scalar, 3, 1>& rpy_vector, const Eigen::Matrix<Scalar, 3, 1>& rpy_velocity,
+                                                                                       const Eigen::Matrix<Scalar, 3, 1>& rpy_acceleration)
+{
+  Eigen::Matrix<Scalar, 3, 1> c_dot;
+  Eigen::Matrix<Scalar, 3, 3> c;
+
+  c_dot << -std::cos(rpy_vector[1]) * rpy_velocity[1] * rpy_velocity[2],
+           -std::sin(rpy_vector[0]) * rpy_velocity[0] * rpy_velocity[1] - std::sin(rpy_vector[0]) * std::sin(rpy_vector[1]) * rpy_velocity[1] * rpy_velocity[2] + std::cos(rpy_vector[0]) * std::cos(rpy_vector[1]) * rpy_velocity[0] * rpy_velocity[2],
+           -std::cos(rpy_vector[0]) * rpy_velocity[0] * rpy_velocity[1] - std::sin(rpy_vector[0]) * std::cos(rpy_vector[1]) * rpy_velocity[0] * rpy_velocity[2] - std::cos(rpy_vector[0]) * std::sin(rpy_vector[1]) * rpy_velocity[1] * rpy_velocity[2];
+
+  c << 1.0, 0.0,                      -std::sin(rpy_vector(1)),
+        0.0, std::cos(rpy_vector(0)),  std::sin(rpy_vector(0))*std::cos(rpy_vector(1)),
+        0.0, -std::sin(rpy_vector(0)), std::cos(rpy_vector(0))*std::cos(rpy_vector(1));
+
+  return c_dot + c * rpy_acceleration;
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::matrixLogarithm(const Eigen::Matrix<Scalar, 3, 3>& R)
+{
+  Eigen::Matrix<Scalar, 3, 1> l;
+  Eigen::Matrix<Scalar, 3, 1> rotation_vector = Eigen::Matrix<Scalar, 3, 1>::Zero();
+
+  if (R.isIdentity())
+    return rotation_vector;
+
+  if (R.isDiagonal())
+  {
+    rotation_vector << R(0, 0) + 1, R(1, 1) + 1, R(2, 2) + 1;
+    return rotation_vector * Scalar(M_PI_2);
+  }
+
+  l << R(2, 1) - R(1, 2),
+      R(0, 2) - R(2, 0),
+      R(1, 0) - R(0, 1);
+  Scalar theta = std::atan2(l.norm(), R(0, 0) + R(1, 1) + R(2, 2) - 1);
+  return theta * (l / l.norm());
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> robotis_manipulator::math::skewSymmetricMatrix(const Eigen::Matrix<Scalar, 3, 1>& v)
+{
+  Eigen::Matrix<Scalar, 3, 3> skew_symmetric_matrix;
+  skew_symmetric_matrix << 0.0, -v(2), v(1),
+      v(2), 0.0, -v(0),
+      -v(1), v(0), 0.0;
+  return skew_symmetric_matrix;
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> robotis_manipulator::math::rodriguesRotationMatrix(const Eigen::Matrix<Scalar, 3, 1>& axis, typename Eigen::NumTraits<Scalar>::Real angle)
+{
+  const Eigen::Matrix<Scalar, 3, 3> skew_symmetric_matrix = skewSymmetricMatrix<Scalar>(axis);
+  return Eigen::Matrix<Scalar, 3, 3>::Identity() +
+         skew_symmetric_matrix * std::sin(angle) +
+         skew_symmetric_matrix * skew_symmetric_matrix * (1 - std::cos(angle));
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::positionDifference(const Eigen::Matrix<Scalar, 3, 1>& desired_position, const Eigen::Matrix<Scalar, 3, 1>& present_position)
+{
+  return desired_position - present_position;
+}
+
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::orientationDifference(const Eigen::Matrix<Scalar, 3, 3>& desired_orientation, const Eigen::Matrix<Scalar, 3, 3>& present_orientation)
+{
+  return present_orientation * matrixLogarithm<Scalar>(present_orientation.transpose() * desired_orientation);
+}
+
+#define ROBOTIS_MANIPULATOR_MATH_INSTANTIATE(Scalar) \
+  template Eigen::Matrix<Scalar, 3, 3> robotis_manipulator::math::convertRollAngleToRotationMatrix<Scalar>(Scalar); \
+  template Eigen::Matrix<Scalar, 3, 3> robotis_manipulator::math::convertPitchAngleToRotationMatrix<Scalar>(Scalar); \
+  template Eigen::Matrix<Scalar, 3, 3> robotis_manipulator::math::convertYawAngleToRotationMatrix<Scalar>(Scalar); \
+  template Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::convertRotationMatrixToRPYVector<Scalar>(const Eigen::Matrix<Scalar, 3, 3>&); \
+  template Eigen::Matrix<Scalar, 3, 3> robotis_manipulator::math::convertRPYToRotationMatrix<Scalar>(Scalar, Scalar, Scalar); \
+  template Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::convertOmegaToRPYVelocity<Scalar>(const Eigen::Matrix<Scalar, 3, 1>&, const Eigen::Matrix<Scalar, 3, 1>&); \
+  template Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::convertRPYVelocityToOmega<Scalar>(const Eigen::Matrix<Scalar, 3, 1>&, const Eigen::Matrix<Scalar, 3, 1>&); \
+  template Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::convertOmegaDotToRPYAcceleration<Scalar>(const Eigen::Matrix<Scalar, 3, 1>&, const Eigen::Matrix<Scalar, 3, 1>&, const Eigen::Matrix<Scalar, 3, 1>&); \
+  template Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::convertRPYAccelerationToOmegaDot<Scalar>(const Eigen::Matrix<Scalar, 3, 1>&, const Eigen::Matrix<Scalar, 3, 1>&, const Eigen::Matrix<Scalar, 3, 1>&); \
+  template Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::matrixLogarithm<Scalar>(const Eigen::Matrix<Scalar, 3, 3>&); \
+  template Eigen::Matrix<Scalar, 3, 3> robotis_manipulator::math::skewSymmetricMatrix<Scalar>(const Eigen::Matrix<Scalar, 3, 1>&); \
+  template Eigen::Matrix<Scalar, 3, 3> robotis_manipulator::math::rodriguesRotationMatrix<Scalar>(const Eigen::Matrix<Scalar, 3, 1>&, Scalar); \
+  template Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::positionDifference<Scalar>(const Eigen::Matrix<Scalar, 3, 1>&, const Eigen::Matrix<Scalar, 3, 1>&); \
+  template Eigen::Matrix<Scalar, 3, 1> robotis_manipulator::math::orientationDifference<Scalar>(const Eigen::Matrix<Scalar, 3, 3>&, const Eigen::Matrix<Scalar, 3, 3>&);
+
+ROBOTIS_MANIPULATOR_MATH_INSTANTIATE(float)
+ROBOTIS_MANIPULATOR_MATH_INSTANTIATE(double)
+
+#undef ROBOTIS_MANIPULATOR_MATH_INSTANTIATE
@@ -20,116 +20,375 @@
 
 using namespace robotis_manipulator;
 
-MinimumJerk::MinimumJerk()
+namespace
 {
-  coefficient_ = Eigen::VectorXd::Zero(6);
+// Horner form of the quintic and its derivatives, sharing the same powers of tick.
+template <typename Derived>
+inline void evaluateMinimumJerk(const Eigen::MatrixBase<Derived> &c,
+                                typename Derived::Scalar tick,
+                                typename Derived::Scalar *position,
+                                typename Derived::Scalar *velocity,
+                                typename Derived::Scalar *acceleration)
+{
+  *position = c(0) + tick * (c(1) + tick * (c(2) + tick * (c(3) + tick * (c(4) + tick * c(5)))));
+  *velocity = c(1) + tick * (2 * c(2) + tick * (3 * c(3) + tick * (4 * c(4) + tick * 5 * c(5))));
+  *acceleration = 2 * c(2) + tick * (6 * c(3) + tick * (12 * c(4) + tick * 20 * c(5)));
+}
+
+template <typename Derived>
+inline void evaluateMinimumJerk(const Eigen::MatrixBase<Derived> &c, typename Derived::Scalar tick, Point *point)
+{
+  typename Derived::Scalar position, velocity, acceleration;
+  evaluateMinimumJerk(c, tick, &position, &velocity, &acceleration);
+  point->position = position;
+  point->velocity = velocity;
+  point->acceleration = acceleration;
+  point->effort = 0.0;
+}
+
+// Same Horner form over many ticks at once, one output column per axis.
+template <typename Scalar>
+void evaluateMinimumJerk(const Eigen::Matrix<Scalar, 6, Eigen::Dynamic> &c,
+                         Eigen::Index size,
+                         const Eigen::Ref<const Eigen::VectorXd> &tick,
+                         Eigen::MatrixXd *position,
+                         Eigen::MatrixXd *velocity,
+                         Eigen::MatrixXd *acceleration)
+{
+  const auto t = tick.array().template cast<Scalar>();
+
+  if (position != nullptr)
+  {
+    position->resize(tick.size(), size);
+    for (Eigen::Index index = 0; index < size; index++)
+      position->col(index).array() = (c(0, index) + t * (c(1, index) + t * (c(2, index) + t * (c(3, index) + t * (c(4, index) + t * c(5, index)))))).template cast<double>();
+  }
+  if (velocity != nullptr)
+  {
+    velocity->resize(tick.size(), size);
+    for (Eigen::Index index = 0; index < size; index++)
+      velocity->col(index).array() = (c(1, index) + t * (2 * c(2, index) + t * (3 * c(3, index) + t * (4 * c(4, index) + t * 5 * c(5, index))))).template cast<double>();
+  }
+  if (acceleration != nullptr)
+  {
+    acceleration->resize(tick.size(), size);
+    for (Eigen::Index index = 0; index < size; index++)
+      acceleration->col(index).array() = (2 * c(2, index) + t * (6 * c(3, index) + t * (12 * c(4, index) + t * 20 * c(5, index)))).template cast<double>();
+  }
+}
+
+// Angle equal to angle modulo 2 pi and within pi of reference, so RPY differences do not jump across the +-pi wrap.
+template <typename Scalar>
+inline Scalar unwrapAngle(Scalar angle, Scalar reference)
+{
+  const Scalar difference = angle - reference;
+  return reference + std::atan2(std::sin(difference), std::cos(difference));
+}
+
+// Velocity at a via point: mean of the neighbouring average slopes, or zero where the direction reverses.
+inline double calcViaPointVelocity(double previous, double via, double next, double previous_time, double next_time)
+{
+  double previous_slope = (via - previous) / previous_time;
+  double next_slope = (next - via) / next_time;
+
+  if (previous_slope * next_slope <= 0.0)
+    return 0.0;
+  return 0.5 * (previous_slope + next_slope);
+}
+
+// Angular velocity at a SLERP via point. Each SLERP segment turns about its own fixed axis, so the rotation
+// only carries through a via point whose two segments share the axis, otherwise it stops there.
+inline Eigen::Vector3d calcSlerpViaPointVelocity(const Eigen::Matrix3d &previous, const Eigen::Matrix3d &via, const Eigen::Matrix3d &next,
+                                                 double previous_time, double next_time)
+{
+  Eigen::AngleAxisd previous_rotation(Eigen::Matrix3d(previous.transpose() * via));
+  Eigen::AngleAxisd next_rotation(Eigen::Matrix3d(via.transpose() * next));
+  if (previous_rotation.angle() < 1e-9 || next_rotation.angle() < 1e-9)
+    return Eigen::Vector3d::Zero();
+
+  Eigen::Vector3d previous_axis = previous * previous_rotation.axis();
+  Eigen::Vector3d next_axis = via * next_rotation.axis();
+  if (previous_axis.dot(next_axis) < 1.0 - 1e-9)
+    return Eigen::Vector3d::Zero();
+  return previous_axis * calcViaPointVelocity(0.0, previous_rotation.angle(), previous_rotation.angle() + next_rotation.angle(),
+                                              previous_time, next_time);
+}
+
+inline double evaluatePolynomial(const std::vector<double> &c, double tick)
+{
+  double value = 0.0;
+  for (size_t index = c.size(); index > 0; index--)
+    value = value * tick + c[index - 1];
+  return value;
 }
 
-MinimumJerk::~MinimumJerk() {}
+// Real roots in [lower, upper] of sum c[i] * tick^i. The roots of the derivative split the
+// interval into monotonic pieces, each holding at most one root which is found by bisection.
+void findPolynomialRoot(std::vector<double> c, double lower, double upper, std::vector<double> *root)
+{
+  root->clear();
+  while (c.size() > 1 && c.back() == 0.0)
+    c.pop_back();
+  if (c.size() < 2)
+    return;
+  if (c.size() == 2)
+  {
+    double r = -c[0] / c[1];
+    if (r >= lower && r <= upper)
+      root->push_back(r);
+    return;
+  }
+
+  std::vector<double> derivative(c.size() - 1);
+  for (size_t index = 1; index < c.size(); index++)
+    derivative[index - 1] = index * c[index];
 
-void MinimumJerk::calcCoefficient(Point start,
-                                  Point goal,
-                                  double move_time)
+  std::vector<double> bound;
+  findPolynomialRoot(derivative, lower, upper, &bound);
+  bound.insert(bound.begin(), lower);
+  bound.push_back(upper);
+
+  for (size_t index = 0; index + 1 < bound.size(); index++)
+  {
+    double a = bound[index], b = bound[index + 1];
+    double fa = evaluatePolynomial(c, a), fb = evaluatePolynomial(c, b);
+    if (fa == 0.0)
+    {
+      root->push_back(a);
+      continue;
+    }
+    if (fa * fb > 0.0)
+      continue;
+    for (uint8_t iteration = 0; iteration < 100 && b - a > 1e-12; iteration++)
+    {
+      double m = 0.5 * (a + b);
+      double fm = evaluatePolynomial(c, m);
+      if (fa * fm <= 0.0)
+        b = m;
+      else
+      {
+        a = m;
+        fa = fm;
+      }
+    }
+    root->push_back(0.5 * (a + b));
+  }
+}
+
+// Segment of tick(begin) and the end of the run of following ticks in the same segment.
+Eigen::Index findSegmentRun(const std::vector<double> &segment_start_time,
+                            const Eigen::Ref<const Eigen::VectorXd> &tick,
+                            Eigen::Index begin,
+                            uint32_t *segment)
 {
-  Eigen::Matrix3d A = Eigen::Matrix3d::Identity(3, 3);
-  Eigen::Vector3d x = Eigen::Vector3d::Zero();
-  Eigen::Vector3d b = Eigen::Vector3d::Zero();
+  uint32_t index = std::upper_bound(segment_start_time.begin(), segment_start_time.end(), tick(begin)) - segment_start_time.begin();
+  *segment = (index == 0) ? 0 : index - 1;
+  const double start_time = segment_start_time.at(*segment);
+  const bool is_last = (*segment + 1 == segment_start_time.size());
+
+  Eigen::Index end = begin + 1;
+  while (end < tick.size() && tick(end) >= start_time && (is_last || tick(end) < segment_start_time.at(*segment + 1)))
+    end++;
+  return end;
+}
+} // namespace
 
-  A << pow(move_time, 3), pow(move_time, 4), pow(move_time, 5),
-      3 * pow(move_time, 2), 4 * pow(move_time, 3), 5 * pow(move_time, 4),
-      6 * pow(move_time, 1), 12 * pow(move_time, 2), 20 * pow(move_time, 3);
+template <typename Scalar>
+BasicMinimumJerk<Scalar>::BasicMinimumJerk()
+{
+  coefficient_ = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>::Zero(6);
+}
+
+template <typename Scalar>
+BasicMinimumJerk<Scalar>::~BasicMinimumJerk() {}
 
-  coefficient_(0) = start.position;
-  coefficient_(1) = start.velocity;
-  coefficient_(2) = 0.5 * start.acceleration;
+template <typename Scalar>
+void BasicMinimumJerk<Scalar>::calcCoefficient(Point start,
+                                               Point goal,
+                                               double move_time)
+{
+  const Eigen::Vector3d start_boundary(start.position, start.velocity, start.acceleration);
+  const Eigen::Vector3d goal_boundary(goal.position, goal.velocity, goal.acceleration);
+  solveCoefficient(start_boundary, goal_boundary, move_time, &coefficient_);
+}
 
-  b << (goal.position - start.position - (start.velocity * move_time + 0.5 * start.acceleration * pow(move_time, 2))),
-      (goal.velocity - start.velocity - (start.acceleration * move_time)),
-      (goal.acceleration - start.acceleration);
+template <typename Scalar>
+void BasicMinimumJerk<Scalar>::calcCoefficient(const std::vector<Point> &start,
+                                               const std::vector<Point> &goal,
+                                               double move_time,
+                                               Coefficient *coefficient)
+{
+  const Eigen::Index size = start.size();
+  Eigen::Matrix<double, 3, Eigen::Dynamic> start_boundary(3, size);
+  Eigen::Matrix<double, 3, Eigen::Dynamic> goal_boundary(3, size);
+  for (Eigen::Index index = 0; index < size; index++)
+  {
+    start_boundary.col(index) << start.at(index).position, start.at(index).velocity, start.at(index).acceleration;
+    goal_boundary.col(index) << goal.at(index).position, goal.at(index).velocity, goal.at(index).acceleration;
+  }
 
-  Eigen::ColPivHouseholderQR<Eigen::Matrix3d> dec(A);
-  x = dec.solve(b);
+  coefficient->resize(6, size);
+  solveCoefficient(start_boundary, goal_boundary, move_time, coefficient);
+}
 
-  coefficient_(3) = x(0);
-  coefficient_(4) = x(1);
-  coefficient_(5) = x(2);
+template <typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> BasicMinimumJerk<Scalar>::calcInverseMatrix(Scalar move_time)
+{
+  // Analytic inverse of
+  //   | T^3    T^4    T^5   |
+  //   | 3T^2   4T^3   5T^4  |
+  //   | 6T     12T^2  20T^3 |
+  Eigen::Matrix<Scalar, 3, 3> A_inverse = Eigen::Matrix<Scalar, 3, 3>::Zero();
+  if (move_time <= 0)
+    return A_inverse;
+
+  const Scalar t1 = 1 / move_time;
+  const Scalar t2 = t1 * t1;
+  const Scalar t3 = t2 * t1;
+  const Scalar t4 = t3 * t1;
+  const Scalar t5 = t4 * t1;
+
+  A_inverse <<  10 * t3, -4 * t2,  t1 / 2,
+               -15 * t4,  7 * t3, -1 * t2,
+                 6 * t5, -3 * t4,  t3 / 2;
+  return A_inverse;
 }
 
-Eigen::VectorXd MinimumJerk::getCoefficient()
+template <typename Scalar>
+Eigen::VectorXd BasicMinimumJerk<Scalar>::getCoefficient()
 {
-  return coefficient_;
+  return coefficient_.template cast<double>();
 }
 
 //-------------------- Joint trajectory --------------------//
 
-JointTrajectory::JointTrajectory()
+template <typename Scalar>
+BasicJointTrajectory<Scalar>::BasicJointTrajectory()
+  : coefficient_size_(0),
+    move_time_(0.0)
 {}
 
-JointTrajectory::~JointTrajectory() {}
+template <typename Scalar>
+BasicJointTrajectory<Scalar>::~BasicJointTrajectory() {}
 
-bool JointTrajectory::makeJointTrajectory(double move_time, JointWaypoint start,
+template <typename Scalar>
+bool BasicJointTrajectory<Scalar>::makeJointTrajectory(double move_time, JointWaypoint start,
                            JointWaypoint goal)
 {
+  move_time_ = move_time;
   coefficient_size_ = start.size();
-  minimum_jerk_coefficient_.resize(6,coefficient_size_);
-  for (uint8_t index = 0; index < coefficient_size_; index++)
-  {
-    minimum_jerk_trajectory_generator_.calcCoefficient(start.at(index),
-                                    goal.at(index),
-                                    move_time);
-
-    minimum_jerk_coefficient_.col(index) = minimum_jerk_trajectory_generator_.getCoefficient();
-  }
+  minimum_jerk_trajectory_generator_.calcCoefficient(start, goal, move_time, &minimum_jerk_coefficient_);
   return true;
 }
 
-JointWaypoint JointTrajectory::getJointWaypoint(double tick)
+template <typename Scalar>
+JointWaypoint BasicJointTrajectory<Scalar>::getJointWaypoint(double tick)
 {
   JointWaypoint joint_way_point;
-  for (uint8_t index = 0; index < coefficient_size_; index++)
-  {
-    JointValue single_joint_way_point;
-
-    single_joint_way_point.position = minimum_jerk_coefficient_(0, index) +
-             minimum_jerk_coefficient_(1, index) * pow(tick, 1) +
-             minimum_jerk_coefficient_(2, index) * pow(tick, 2) +
-             minimum_jerk_coefficient_(3, index) * pow(tick, 3) +
-             minimum_jerk_coefficient_(4, index) * pow(tick, 4) +
-             minimum_jerk_coefficient_(5, index) * pow(tick, 5);
+  getJointWaypoint(tick, &joint_way_point);
+  return joint_way_point;
+}
 
-    single_joint_way_point.velocity = minimum_jerk_coefficient_(1, index) +
-             2 * minimum_jerk_coefficient_(2, index) * pow(tick, 1) +
-             3 * minimum_jerk_coefficient_(3, index) * pow(tick, 2) +
-             4 * minimum_jerk_coefficient_(4, index) * pow(tick, 3) +
-             5 * minimum_jerk_coefficient_(5, index) * pow(tick, 4);
+template <typename Scalar>
+void BasicJointTrajectory<Scalar>::getJointWaypoint(double tick, JointWaypoint *joint_way_point) const
+{
+  if (joint_way_point->size() != coefficient_size_)
+    joint_way_point->resize(coefficient_size_);
 
-    single_joint_way_point.acceleration = 2 * minimum_jerk_coefficient_(2, index) +
-             6 * minimum_jerk_coefficient_(3, index) * pow(tick, 1) +
-             12 * minimum_jerk_coefficient_(4, index) * pow(tick, 2) +
-             20 * minimum_jerk_coefficient_(5, index) * pow(tick, 3);
+  for (uint8_t index = 0; index < coefficient_size_; index++)
+    evaluateMinimumJerk(minimum_jerk_coefficient_.col(index), tick, &joint_way_point->at(index));
+}
 
-    single_joint_way_point.effort = 0.0;
+template <typename Scalar>
+void BasicJointTrajectory<Scalar>::sampleJointWaypoint(const Eigen::Ref<const Eigen::VectorXd> &tick,
+                                                       Eigen::MatrixXd *position,
+                                                       Eigen::MatrixXd *velocity,
+                                                       Eigen::MatrixXd *acceleration) const
+{
+  evaluateMinimumJerk(minimum_jerk_coefficient_, coefficient_size_, tick, position, velocity, acceleration);
+}
 
-    joint_way_point.push_back(single_joint_way_point);
+template <typename Scalar>
+void BasicJointTrajectory<Scalar>::getJointExtremum(uint8_t index, Limit *position, Limit *velocity) const
+{
+  // Root finding stays in double, it only runs when a trajectory is planned
+  const Eigen::Matrix<double, 6, 1> c = minimum_jerk_coefficient_.col(index).template cast<double>();
+  std::vector<double> candidate_tick;
+  std::vector<double> root;
+  Point point;
+
+  // Position extrema at the ends and where velocity is zero
+  candidate_tick.push_back(0.0);
+  candidate_tick.push_back(move_time_);
+  findPolynomialRoot({c(1), 2.0 * c(2), 3.0 * c(3), 4.0 * c(4), 5.0 * c(5)}, 0.0, move_time_, &root);
+  candidate_tick.insert(candidate_tick.end(), root.begin(), root.end());
+
+  // Velocity extrema at the ends and where acceleration is zero
+  findPolynomialRoot({2.0 * c(2), 6.0 * c(3), 12.0 * c(4), 20.0 * c(5)}, 0.0, move_time_, &root);
+  candidate_tick.insert(candidate_tick.end(), root.begin(), root.end());
+
+  evaluateMinimumJerk(c, 0.0, &point);
+  position->maximum = position->minimum = point.position;
+  velocity->maximum = velocity->minimum = point.velocity;
+  for (uint32_t candidate = 1; candidate < candidate_tick.size(); candidate++)
+  {
+    evaluateMinimumJerk(c, candidate_tick.at(candidate), &point);
+    position->maximum = std::max(position->maximum, point.position);
+    position->minimum = std::min(position->minimum, point.position);
+    velocity->maximum = std::max(velocity->maximum, point.velocity);
+    velocity->minimum = std::min(velocity->minimum, point.velocity);
   }
+}
 
-  return joint_way_point;
+template <typename Scalar>
+Eigen::MatrixXd BasicJointTrajectory<Scalar>::getMinimumJerkCoefficient()
+{
+  return minimum_jerk_coefficient_.template cast<double>();
+}
+
+template <typename Scalar>
+uint8_t BasicJointTrajectory<Scalar>::getSize() const
+{
+  return coefficient_size_;
 }
 
-Eigen::MatrixXd JointTrajectory::getMinimumJerkCoefficient()
+template <typename Scalar>
+double BasicJointTrajectory<Scalar>::getMoveTime() const
 {
-  return minimum_jerk_coefficient_;
+  return move_time_;
 }
 
 //-------------------- Task trajectory --------------------//
 
-TaskTrajectory::TaskTrajectory()
+template <typename Scalar>
+BasicTaskTrajectory<Scalar>::BasicTaskTrajectory()
+  : coefficient_size_(0),
+    orientation_interpolation_(RPY_INTERPOLATION),
+    start_orientation_(Eigen::Quaternion<Scalar>::Identity()),
+    goal_orientation_(Eigen::Quaternion<Scalar>::Identity()),
+    rotation_axis_(Vector3::UnitZ()),
+    rotation_angle_(0)
+{
+  minimum_jerk_coefficient_ = Eigen::Matrix<Scalar, 6, 4>::Identity();
+}
+
+template <typename Scalar>
+BasicTaskTrajectory<Scalar>::~BasicTaskTrajectory() {}
+
+template <typename Scalar>
+void BasicTaskTrajectory<Scalar>::setOrientationInterpolation(OrientationInterpolation orientation_interpolation)
 {
-  minimum_jerk_coefficient_ = Eigen::MatrixXd::Identity(6, 4);
+  orientation_interpolation_ = orientation_interpolation;
 }
-TaskTrajectory::~TaskTrajectory() {}
 
-bool TaskTrajectory::makeTaskTrajectory(double move_time, TaskWaypoint start,
+template <typename Scalar>
+OrientationInterpolation BasicTaskTrajectory<Scalar>::getOrientationInterpolation()
+{
+  return orientation_interpolation_;
+}
+
+template <typename Scalar>
+bool BasicTaskTrajectory<Scalar>::makeTaskTrajectory(double move_time, TaskWaypoint start,
                            TaskWaypoint goal)
 {
   std::vector<Point> start_way_point;
@@ -154,22 +413,59 @@ bool TaskTrajectory::makeTaskTrajectory(double move_time, TaskWaypoint start,
   ////////////////////////////////////////////////////////////////////////////////
 
   //////////////////////////////////orientation///////////////////////////////////
+  const Eigen::Matrix<Scalar, 3, 3> start_orientation = start.kinematic.orientation.cast<Scalar>();
+  const Eigen::Matrix<Scalar, 3, 3> goal_orientation = goal.kinematic.orientation.cast<Scalar>();
+  const Vector3 start_angular_velocity = start.dynamic.angular.velocity.cast<Scalar>();
+  const Vector3 start_angular_acceleration = start.dynamic.angular.acceleration.cast<Scalar>();
+  const Vector3 goal_angular_velocity = goal.dynamic.angular.velocity.cast<Scalar>();
+  const Vector3 goal_angular_acceleration = goal.dynamic.angular.acceleration.cast<Scalar>();
+
+  if (orientation_interpolation_ == SLERP_INTERPOLATION)
+  {
+    // Rotation from start to goal about one fixed axis, the angle follows a minimum jerk profile.
+    // Only the part of the boundary angular velocity and acceleration along the axis is kept.
+    start_orientation_ = Eigen::Quaternion<Scalar>(start_orientation);
+    goal_orientation_ = Eigen::Quaternion<Scalar>(goal_orientation);
+    Eigen::AngleAxis<Scalar> rotation(Eigen::Matrix<Scalar, 3, 3>(start_orientation.transpose() * goal_orientation));
+    rotation_angle_ = rotation.angle();
+    rotation_axis_ = start_orientation * rotation.axis();
+
+    Point angle_temp;
+    angle_temp.position = 0.0;
+    angle_temp.velocity = rotation_axis_.dot(start_angular_velocity);
+    angle_temp.acceleration = rotation_axis_.dot(start_angular_acceleration);
+    angle_temp.effort = 0.0;
+    start_way_point.push_back(angle_temp);
+
+    angle_temp.position = rotation_angle_;
+    angle_temp.velocity = rotation_axis_.dot(goal_angular_velocity);
+    angle_temp.acceleration = rotation_axis_.dot(goal_angular_acceleration);
+    goal_way_point.push_back(angle_temp);
+
+    coefficient_size_ = start_way_point.size();
+    minimum_jerk_trajectory_generator_.calcCoefficient(start_way_point, goal_way_point, move_time, &minimum_jerk_coefficient_);
+    return true;
+  }
+
+  Vector3 start_orientation_rpy;
+  Vector3 start_ang_vel_rpy;
+  Vector3 start_ang_acc_rpy;
 
-  Eigen::Vector3d start_orientation_rpy;
-  Eigen::Vector3d start_ang_vel_rpy;
-  Eigen::Vector3d start_ang_acc_rpy;
+  start_orientation_rpy = math::convertRotationMatrixToRPYVector<Scalar>(start_orientation);
+  start_ang_vel_rpy = math::convertOmegaToRPYVelocity<Scalar>(start_orientation_rpy, start_angular_velocity);
+  start_ang_acc_rpy = math::convertOmegaDotToRPYAcceleration<Scalar>(start_orientation_rpy, start_ang_vel_rpy, start_angular_acceleration);
 
-  start_orientation_rpy = math::convertRotationMatrixToRPYVector(start.kinematic.orientation);
-  start_ang_vel_rpy = math::convertOmegaToRPYVelocity(start_orientation_rpy, start.dynamic.angular.velocity);
-  start_ang_acc_rpy = math::convertOmegaDotToRPYAcceleration(start_orientation_rpy, start_ang_vel_rpy, start.dynamic.angular.acceleration);
+  Vector3 goal_orientation_rpy;
+  Vector3 goal_ang_vel_rpy;
+  Vector3 goal_ang_acc_rpy;
 
-  Eigen::Vector3d goal_orientation_rpy;
-  Eigen::Vector3d goal_ang_vel_rpy;
-  Eigen::Vector3d goal_ang_acc_rpy;
+  goal_orientation_rpy = math::convertRotationMatrixToRPYVector<Scalar>(goal_orientation);
+  goal_ang_vel_rpy = math::convertOmegaToRPYVelocity<Scalar>(goal_orientation_rpy, goal_angular_velocity);
+  goal_ang_acc_rpy = math::convertOmegaDotToRPYAcceleration<Scalar>(goal_orientation_rpy, goal_ang_vel_rpy, goal_angular_acceleration);
 
-  goal_orientation_rpy = math::convertRotationMatrixToRPYVector(goal.kinematic.orientation);
-  goal_ang_vel_rpy = math::convertOmegaToRPYVelocity(goal_orientation_rpy, goal.dynamic.angular.velocity);
-  start_ang_acc_rpy = math::convertOmegaDotToRPYAcceleration(goal_orientation_rpy, goal_ang_vel_rpy, goal.dynamic.angular.acceleration);
+  // Same goal orientation, reached the short way across the +-pi wrap
+  for(uint8_t i = 0; i < 3; i++)
+    goal_orientation_rpy[i] = unwrapAngle(goal_orientation_rpy[i], start_orientation_rpy[i]);
 
   for(uint8_t i = 0; i < 3; i++)    //roll, pitch, yaw
   {
@@ -189,85 +485,632 @@ bool TaskTrajectory::makeTaskTrajectory(double move_time, TaskWaypoint start,
   ////////////////////////////////////////////////////////////////////////////////
 
   coefficient_size_ = start_way_point.size();
-  minimum_jerk_coefficient_.resize(6,coefficient_size_);
+  minimum_jerk_trajectory_generator_.calcCoefficient(start_way_point, goal_way_point, move_time, &minimum_jerk_coefficient_);
+  return true;
+}
+
+template <typename Scalar>
+TaskWaypoint BasicTaskTrajectory<Scalar>::getTaskWaypoint(double tick)
+{
+  AxisState state;
   for (uint8_t index = 0; index < coefficient_size_; index++)
+    evaluateMinimumJerk(minimum_jerk_coefficient_.col(index), tick, &state(0, index), &state(1, index), &state(2, index));
+
+  TaskWaypoint task_way_point;
+  convertAxisStateToTaskWaypoint(state, &task_way_point);
+  return task_way_point;
+}
+
+template <typename Scalar>
+void BasicTaskTrajectory<Scalar>::sampleTaskWaypoint(const Eigen::Ref<const Eigen::VectorXd> &tick, std::vector<TaskWaypoint> *task_way_point) const
+{
+  Eigen::MatrixXd position, velocity, acceleration;
+  evaluateMinimumJerk(minimum_jerk_coefficient_, coefficient_size_, tick, &position, &velocity, &acceleration);
+
+  if (task_way_point->size() != static_cast<size_t>(tick.size()))
+    task_way_point->resize(tick.size());
+
+  AxisState state;
+  for (Eigen::Index sample = 0; sample < tick.size(); sample++)
+  {
+    for (uint8_t index = 0; index < coefficient_size_; index++)
+    {
+      state(0, index) = position(sample, index);
+      state(1, index) = velocity(sample, index);
+      state(2, index) = acceleration(sample, index);
+    }
+    convertAxisStateToTaskWaypoint(state, &task_way_point->at(sample));
+  }
+}
+
+template <typename Scalar>
+void BasicTaskTrajectory<Scalar>::convertAxisStateToTaskWaypoint(const AxisState &state, TaskWaypoint *task_way_point) const
+{
+  ////////////////////////////////////position////////////////////////////////////
+  for(uint8_t i = 0; i < 3; i++)        //x ,y ,z
+  {
+    task_way_point->kinematic.position[i] = state(0, i);
+    task_way_point->dynamic.linear.velocity[i] = state(1, i);
+    task_way_point->dynamic.linear.acceleration[i] = state(2, i);
+  }
+  ////////////////////////////////////////////////////////////////////////////////
+
+  //////////////////////////////////orientation///////////////////////////////////
+  if (orientation_interpolation_ == SLERP_INTERPOLATION)
+  {
+    if (rotation_angle_ > Scalar(1e-9))
+      task_way_point->kinematic.orientation = start_orientation_.slerp(state(0, 3) / rotation_angle_, goal_orientation_).toRotationMatrix().template cast<double>();
+    else
+      task_way_point->kinematic.orientation = start_orientation_.toRotationMatrix().template cast<double>();
+    task_way_point->dynamic.angular.velocity = (rotation_axis_ * state(1, 3)).template cast<double>();
+    task_way_point->dynamic.angular.acceleration = (rotation_axis_ * state(2, 3)).template cast<double>();
+    return;
+  }
+
+  const Vector3 rpy_orientation = state.row(0).template segment<3>(3).transpose();
+  const Vector3 rpy_velocity = state.row(1).template segment<3>(3).transpose();
+  const Vector3 rpy_acceleration = state.row(2).template segment<3>(3).transpose();
+  task_way_point->kinematic.orientation = math::convertRPYToRotationMatrix<Scalar>(rpy_orientation(0),   //roll
+                                                                                  rpy_orientation(1),   //pitch
+                                                                                  rpy_orientation(2)    //yaw
+                                                                                  ).template cast<double>();
+  task_way_point->dynamic.angular.velocity = math::convertRPYVelocityToOmega<Scalar>(rpy_orientation, rpy_velocity).template cast<double>();
+  task_way_point->dynamic.angular.acceleration = math::convertRPYAccelerationToOmegaDot<Scalar>(rpy_orientation, rpy_velocity, rpy_acceleration).template cast<double>();
+}
+
+template <typename Scalar>
+Eigen::MatrixXd BasicTaskTrajectory<Scalar>::getMinimumJerkCoefficient()
+{
+  return minimum_jerk_coefficient_.template cast<double>();
+}
+
+namespace robotis_manipulator
+{
+template class BasicMinimumJerk<float>;
+template class BasicMinimumJerk<double>;
+template class BasicJointTrajectory<float>;
+template class BasicJointTrajectory<double>;
+template class BasicTaskTrajectory<float>;
+template class BasicTaskTrajectory<double>;
+} // namespace robotis_manipulator
+
+//-------------------- S-curve --------------------//
+
+SCurve::SCurve()
+  : distance_(0.0),
+    jerk_(0.0),
+    jerk_time_(0.0),
+    acceleration_time_(0.0),
+    constant_velocity_time_(0.0),
+    max_reached_acceleration_(0.0),
+    max_reached_velocity_(0.0)
+{}
+
+SCurve::~SCurve() {}
+
+bool SCurve::calcProfile(double distance,
+                         double max_velocity,
+                         double max_acceleration,
+                         double max_jerk)
+{
+  distance_ = 0.0;
+  jerk_ = 0.0;
+  jerk_time_ = 0.0;
+  acceleration_time_ = 0.0;
+  constant_velocity_time_ = 0.0;
+  max_reached_acceleration_ = 0.0;
+  max_reached_velocity_ = 0.0;
+
+  if (max_velocity <= 0.0 || max_acceleration <= 0.0 || max_jerk <= 0.0)
+  {
+    log::error("[calcProfile] Limits should be positive.");
+    return false;
+  }
+  if (distance <= 0.0)
+    return true;
+
+  const double V = max_velocity;
+  const double A = max_acceleration;
+  const double J = max_jerk;
+
+  // Acceleration phase reaching max_velocity
+  double jerk_time = A / J;
+  double acceleration_time = jerk_time + V / A;
+  if (V * J < A * A)    // max_acceleration is never reached
   {
-    minimum_jerk_trajectory_generator_.calcCoefficient(start_way_point.at(index),
-                                    goal_way_point.at(index),
-                                    move_time);
+    jerk_time = sqrt(V / J);
+    acceleration_time = 2.0 * jerk_time;
+  }
+  double constant_velocity_time = distance / V - acceleration_time;
 
-    minimum_jerk_coefficient_.col(index) = minimum_jerk_trajectory_generator_.getCoefficient();
+  // Too short to reach max_velocity
+  if (constant_velocity_time < 0.0)
+  {
+    constant_velocity_time = 0.0;
+    jerk_time = A / J;
+    acceleration_time = 0.5 * (jerk_time + sqrt(jerk_time * jerk_time + 4.0 * distance / A));
+    if (acceleration_time < 2.0 * jerk_time)    // max_acceleration is never reached either
+    {
+      jerk_time = cbrt(distance / (2.0 * J));
+      acceleration_time = 2.0 * jerk_time;
+    }
   }
+
+  distance_ = distance;
+  jerk_ = J;
+  jerk_time_ = jerk_time;
+  acceleration_time_ = acceleration_time;
+  constant_velocity_time_ = constant_velocity_time;
+  max_reached_acceleration_ = J * jerk_time;
+  max_reached_velocity_ = (acceleration_time - jerk_time) * max_reached_acceleration_;
   return true;
 }
 
-TaskWaypoint TaskTrajectory::getTaskWaypoint(double tick)
+double SCurve::getMoveTime() const
 {
-  std::vector<Point> result_point;
-  for (uint8_t index = 0; index < coefficient_size_; index++)
+  return 2.0 * acceleration_time_ + constant_velocity_time_;
+}
+
+double SCurve::getMaxVelocity() const
+{
+  return max_reached_velocity_;
+}
+
+void SCurve::getAccelerationPoint(double tick, Point *point) const
+{
+  const double J = jerk_;
+  const double Tj = jerk_time_;
+  const double Ta = acceleration_time_;
+  const double a = max_reached_acceleration_;
+  const double v = max_reached_velocity_;
+
+  if (tick < Tj)
+  {
+    point->acceleration = J * tick;
+    point->velocity = 0.5 * J * tick * tick;
+    point->position = J * tick * tick * tick / 6.0;
+  }
+  else if (tick < Ta - Tj)
   {
-    Point single_task_way_point;
+    point->acceleration = a;
+    point->velocity = a * (tick - 0.5 * Tj);
+    point->position = a / 6.0 * (3.0 * tick * tick - 3.0 * Tj * tick + Tj * Tj);
+  }
+  else
+  {
+    const double remain = Ta - tick;
+    point->acceleration = J * remain;
+    point->velocity = v - 0.5 * J * remain * remain;
+    point->position = 0.5 * v * Ta - v * remain + J * remain * remain * remain / 6.0;
+  }
+}
 
-    single_task_way_point.position = minimum_jerk_coefficient_(0, index) +
-             minimum_jerk_coefficient_(1, index) * pow(tick, 1) +
-             minimum_jerk_coefficient_(2, index) * pow(tick, 2) +
-             minimum_jerk_coefficient_(3, index) * pow(tick, 3) +
-             minimum_jerk_coefficient_(4, index) * pow(tick, 4) +
-             minimum_jerk_coefficient_(5, index) * pow(tick, 5);
+void SCurve::getPoint(double tick, Point *point) const
+{
+  const double move_time = getMoveTime();
+  point->effort = 0.0;
 
-    single_task_way_point.velocity = minimum_jerk_coefficient_(1, index) +
-             2 * minimum_jerk_coefficient_(2, index) * pow(tick, 1) +
-             3 * minimum_jerk_coefficient_(3, index) * pow(tick, 2) +
-             4 * minimum_jerk_coefficient_(4, index) * pow(tick, 3) +
-             5 * minimum_jerk_coefficient_(5, index) * pow(tick, 4);
+  if (tick <= 0.0)
+  {
+    point->position = 0.0;
+    point->velocity = 0.0;
+    point->acceleration = 0.0;
+  }
+  else if (tick >= move_time)
+  {
+    point->position = distance_;
+    point->velocity = 0.0;
+    point->acceleration = 0.0;
+  }
+  else if (tick < acceleration_time_)
+  {
+    getAccelerationPoint(tick, point);
+  }
+  else if (tick <= acceleration_time_ + constant_velocity_time_)
+  {
+    point->position = 0.5 * max_reached_velocity_ * acceleration_time_ + max_reached_velocity_ * (tick - acceleration_time_);
+    point->velocity = max_reached_velocity_;
+    point->acceleration = 0.0;
+  }
+  else
+  {
+    // Deceleration mirrors acceleration
+    getAccelerationPoint(move_time - tick, point);
+    point->position = distance_ - point->position;
+    point->acceleration = -point->acceleration;
+  }
+}
+
+//-------------------- Joint S-curve trajectory --------------------//
 
-    single_task_way_point.acceleration = 2 * minimum_jerk_coefficient_(2, index) +
-             6 * minimum_jerk_coefficient_(3, index) * pow(tick, 1) +
-             12 * minimum_jerk_coefficient_(4, index) * pow(tick, 2) +
-             20 * minimum_jerk_coefficient_(5, index) * pow(tick, 3);
+JointSCurveTrajectory::JointSCurveTrajectory() {}
 
-    single_task_way_point.effort = 0.0;
+JointSCurveTrajectory::~JointSCurveTrajectory() {}
 
-    result_point.push_back(single_task_way_point);
+bool JointSCurveTrajectory::makeJointTrajectory(JointWaypoint start,
+                                                JointWaypoint goal,
+                                                std::vector<double> max_velocity,
+                                                std::vector<double> max_acceleration,
+                                                std::vector<double> max_jerk)
+{
+  if (start.size() != goal.size() || start.size() != max_velocity.size()
+      || start.size() != max_acceleration.size() || start.size() != max_jerk.size())
+  {
+    log::error("[makeJointTrajectory] Wrong size of S-curve input.");
+    return false;
   }
 
-  TaskWaypoint task_way_point;
-  ////////////////////////////////////position////////////////////////////////////
-  for(uint8_t i = 0; i < 3; i++)        //x ,y ,z
+  // Every joint moves along (goal - start) * s, so the normalized limits of s are
+  // the tightest ratio of limit over distance among the joints.
+  double s_velocity = 0.0;
+  double s_acceleration = 0.0;
+  double s_jerk = 0.0;
+  bool is_moving = false;
+
+  start_.resize(start.size());
+  distance_.resize(start.size());
+  for (uint32_t index = 0; index < start.size(); index++)
   {
-    task_way_point.kinematic.position[i] = result_point.at(i).position;
-    task_way_point.dynamic.linear.velocity[i] = result_point.at(i).velocity;
-    task_way_point.dynamic.linear.acceleration[i] = result_point.at(i).acceleration;
+    if (max_velocity.at(index) <= 0.0 || max_acceleration.at(index) <= 0.0 || max_jerk.at(index) <= 0.0)
+    {
+      log::error("[makeJointTrajectory] Velocity, acceleration and jerk limits should be positive.");
+      return false;
+    }
+    start_.at(index).position = start.at(index).position;
+    start_.at(index).velocity = 0.0;
+    start_.at(index).acceleration = 0.0;
+    start_.at(index).effort = 0.0;
+    distance_.at(index) = goal.at(index).position - start.at(index).position;
+
+    double distance = fabs(distance_.at(index));
+    if (distance < 1e-9)
+      continue;
+
+    if (!is_moving || max_velocity.at(index) / distance < s_velocity)
+      s_velocity = max_velocity.at(index) / distance;
+    if (!is_moving || max_acceleration.at(index) / distance < s_acceleration)
+      s_acceleration = max_acceleration.at(index) / distance;
+    if (!is_moving || max_jerk.at(index) / distance < s_jerk)
+      s_jerk = max_jerk.at(index) / distance;
+    is_moving = true;
   }
-  ////////////////////////////////////////////////////////////////////////////////
 
-  //////////////////////////////////orientation///////////////////////////////////
-  Eigen::Vector3d rpy_orientation;
-  rpy_orientation << result_point.at(3).position, result_point.at(4).position, result_point.at(5).position;
-  task_way_point.kinematic.orientation = math::convertRPYToRotationMatrix(result_point.at(3).position,   //roll
-                                                                       result_point.at(4).position,   //pitch
-                                                                       result_point.at(5).position);   //yaw
+  if (!is_moving)
+    return s_curve_.calcProfile(0.0, 1.0, 1.0, 1.0);
+  return s_curve_.calcProfile(1.0, s_velocity, s_acceleration, s_jerk);
+}
+
+void JointSCurveTrajectory::sampleJointWaypoint(const Eigen::Ref<const Eigen::VectorXd> &tick,
+                                                Eigen::MatrixXd *position,
+                                                Eigen::MatrixXd *velocity,
+                                                Eigen::MatrixXd *acceleration) const
+{
+  Eigen::VectorXd s_position(tick.size()), s_velocity(tick.size()), s_acceleration(tick.size());
+  Point s;
+  for (Eigen::Index sample = 0; sample < tick.size(); sample++)
+  {
+    s_curve_.getPoint(tick(sample), &s);
+    s_position(sample) = s.position;
+    s_velocity(sample) = s.velocity;
+    s_acceleration(sample) = s.acceleration;
+  }
+
+  Eigen::Map<const Eigen::RowVectorXd> distance(distance_.data(), distance_.size());
+  if (position != nullptr)
+  {
+    Eigen::RowVectorXd start(start_.size());
+    for (uint32_t index = 0; index < start_.size(); index++)
+      start(index) = start_.at(index).position;
+    position->resize(tick.size(), start_.size());
+    position->noalias() = s_position * distance;
+    position->rowwise() += start;
+  }
+  if (velocity != nullptr)
+  {
+    velocity->resize(tick.size(), start_.size());
+    velocity->noalias() = s_velocity * distance;
+  }
+  if (acceleration != nullptr)
+  {
+    acceleration->resize(tick.size(), start_.size());
+    acceleration->noalias() = s_acceleration * distance;
+  }
+}
+
+void JointSCurveTrajectory::getJointExtremum(uint8_t index, Limit *position, Limit *velocity) const
+{
+  // Joints move monotonically from start to goal
+  double start = start_.at(index).position;
+  double goal = start + distance_.at(index);
+  double peak_velocity = distance_.at(index) * s_curve_.getMaxVelocity();
+  position->maximum = std::max(start, goal);
+  position->minimum = std::min(start, goal);
+  velocity->maximum = std::max(0.0, peak_velocity);
+  velocity->minimum = std::min(0.0, peak_velocity);
+}
+
+double JointSCurveTrajectory::getMoveTime() const
+{
+  return s_curve_.getMoveTime();
+}
+
+uint8_t JointSCurveTrajectory::getSize() const
+{
+  return start_.size();
+}
+
+JointWaypoint JointSCurveTrajectory::getJointWaypoint(double tick)
+{
+  JointWaypoint joint_way_point;
+  getJointWaypoint(tick, &joint_way_point);
+  return joint_way_point;
+}
+
+void JointSCurveTrajectory::getJointWaypoint(double tick, JointWaypoint *joint_way_point) const
+{
+  if (joint_way_point->size() != start_.size())
+    joint_way_point->resize(start_.size());
+
+  Point s;
+  s_curve_.getPoint(tick, &s);
+  for (uint32_t index = 0; index < start_.size(); index++)
+  {
+    JointValue &value = joint_way_point->at(index);
+    value.position = start_.at(index).position + distance_.at(index) * s.position;
+    value.velocity = distance_.at(index) * s.velocity;
+    value.acceleration = distance_.at(index) * s.acceleration;
+    value.effort = 0.0;
+  }
+}
 
-  Eigen::Vector3d rpy_velocity;
-  rpy_velocity << result_point.at(3).velocity, result_point.at(4).velocity, result_point.at(5).velocity;
-  task_way_point.dynamic.angular.velocity = math::convertRPYVelocityToOmega(rpy_orientation, rpy_velocity);
+//-------------------- Task path trajectory --------------------//
+
+TaskPathTrajectory::TaskPathTrajectory()
+  : is_line_(true),
+    move_time_(0.0),
+    acceleration_time_ratio_(0.2),
+    path_length_(0.0),
+    path_speed_(0.0),
+    start_position_(Eigen::Vector3d::Zero()),
+    line_direction_(Eigen::Vector3d::Zero()),
+    center_(Eigen::Vector3d::Zero()),
+    axis_(Eigen::Vector3d::UnitZ()),
+    radial_(Eigen::Vector3d::UnitX()),
+    tangential_(Eigen::Vector3d::UnitY()),
+    radius_(0.0),
+    axial_rate_(0.0),
+    angle_per_length_(0.0),
+    orientation_(Eigen::Matrix3d::Identity())
+{}
+
+TaskPathTrajectory::~TaskPathTrajectory() {}
+
+void TaskPathTrajectory::setAccelerationTimeRatio(double acceleration_time_ratio)
+{
+  acceleration_time_ratio_ = std::min(std::max(acceleration_time_ratio, 0.0), 0.5);
+}
+
+bool TaskPathTrajectory::makeLineTrajectory(double move_time,
+                                            TaskWaypoint start,
+                                            Eigen::Vector3d goal_position)
+{
+  if (move_time <= 0.0)
+  {
+    log::error("[makeLineTrajectory] Move time should be positive.");
+    return false;
+  }
+  is_line_ = true;
+  move_time_ = move_time;
+  start_position_ = start.kinematic.position;
+  orientation_ = start.kinematic.orientation;
+
+  Eigen::Vector3d displacement = goal_position - start_position_;
+  path_length_ = displacement.norm();
+  line_direction_ = (path_length_ > 0.0) ? Eigen::Vector3d(displacement / path_length_) : Eigen::Vector3d::Zero();
+  path_speed_ = path_length_ / (move_time_ * (1.0 - acceleration_time_ratio_));
+  return true;
+}
+
+bool TaskPathTrajectory::makeHelixTrajectory(double move_time,
+                                             TaskWaypoint start,
+                                             Eigen::Vector3d center,
+                                             Eigen::Vector3d axis,
+                                             double angle,
+                                             double pitch)
+{
+  if (move_time <= 0.0)
+  {
+    log::error("[makeHelixTrajectory] Move time should be positive.");
+    return false;
+  }
+  if (axis.norm() < 1e-9)
+  {
+    log::error("[makeHelixTrajectory] Wrong rotation axis.");
+    return false;
+  }
+  axis_ = axis.normalized();
+  center_ = center + axis_ * axis_.dot(start.kinematic.position - center);   // center in the plane of the start point
+
+  Eigen::Vector3d radius_vector = start.kinematic.position - center_;
+  radius_ = radius_vector.norm();
+  if (radius_ < 1e-9)
+  {
+    log::error("[makeHelixTrajectory] Start position is on the rotation axis.");
+    return false;
+  }
+  radial_ = radius_vector / radius_;
+  tangential_ = axis_.cross(radial_);
+
+  // Advance of pitch per turn in the direction of rotation
+  axial_rate_ = (angle >= 0.0 ? 1.0 : -1.0) * pitch / (2.0 * M_PI);
+
+  is_line_ = false;
+  move_time_ = move_time;
+  start_position_ = start.kinematic.position;
+  orientation_ = start.kinematic.orientation;
+
+  // |dp/dphi| is constant, so the arc length is linear in the angle
+  double length_per_angle = sqrt(radius_ * radius_ + axial_rate_ * axial_rate_);
+  path_length_ = fabs(angle) * length_per_angle;
+  angle_per_length_ = (angle >= 0.0 ? 1.0 : -1.0) / length_per_angle;
+  path_speed_ = path_length_ / (move_time_ * (1.0 - acceleration_time_ratio_));
+  return true;
+}
 
-  Eigen::Vector3d rpy_acceleration;
-  rpy_acceleration << result_point.at(3).acceleration, result_point.at(4).acceleration, result_point.at(5).acceleration;
-  task_way_point.dynamic.angular.acceleration = math::convertRPYAccelerationToOmegaDot(rpy_orientation, rpy_velocity, rpy_acceleration);
+double TaskPathTrajectory::getPathLength() const
+{
+  return path_length_;
+}
 
+void TaskPathTrajectory::getPathPoint(double tick, Point *point) const
+{
+  // Speed ramps of v * (3x^2 - 2x^3), so acceleration starts and ends at zero
+  const double acceleration_time = acceleration_time_ratio_ * move_time_;
+  const double v = path_speed_;
+  point->effort = 0.0;
+
+  if (tick <= 0.0)
+  {
+    point->position = 0.0;
+    point->velocity = 0.0;
+    point->acceleration = 0.0;
+  }
+  else if (tick >= move_time_)
+  {
+    point->position = path_length_;
+    point->velocity = 0.0;
+    point->acceleration = 0.0;
+  }
+  else if (tick < acceleration_time)
+  {
+    double x = tick / acceleration_time;
+    point->position = v * acceleration_time * x * x * x * (1.0 - 0.5 * x);
+    point->velocity = v * x * x * (3.0 - 2.0 * x);
+    point->acceleration = v / acceleration_time * 6.0 * x * (1.0 - x);
+  }
+  else if (tick <= move_time_ - acceleration_time)
+  {
+    point->position = v * (tick - 0.5 * acceleration_time);
+    point->velocity = v;
+    point->acceleration = 0.0;
+  }
+  else
+  {
+    double x = (move_time_ - tick) / acceleration_time;
+    point->position = path_length_ - v * acceleration_time * x * x * x * (1.0 - 0.5 * x);
+    point->velocity = v * x * x * (3.0 - 2.0 * x);
+    point->acceleration = -v / acceleration_time * 6.0 * x * (1.0 - x);
+  }
+}
+
+TaskWaypoint TaskPathTrajectory::getTaskWaypoint(double tick)
+{
+  TaskWaypoint task_way_point;
+  getTaskWaypoint(tick, &task_way_point);
   return task_way_point;
 }
 
-Eigen::MatrixXd TaskTrajectory::getMinimumJerkCoefficient()
+void TaskPathTrajectory::getTaskWaypoint(double tick, TaskWaypoint *task_way_point) const
 {
-  return minimum_jerk_coefficient_;
+  Point s;
+  getPathPoint(tick, &s);
+
+  if (is_line_)
+  {
+    task_way_point->kinematic.position = start_position_ + line_direction_ * s.position;
+    task_way_point->dynamic.linear.velocity = line_direction_ * s.velocity;
+    task_way_point->dynamic.linear.acceleration = line_direction_ * s.acceleration;
+  }
+  else
+  {
+    const double angle = angle_per_length_ * s.position;
+    const double angular_velocity = angle_per_length_ * s.velocity;
+    const double angular_acceleration = angle_per_length_ * s.acceleration;
+    const double c = cos(angle);
+    const double sn = sin(angle);
+
+    Eigen::Vector3d radius_vector = radius_ * (c * radial_ + sn * tangential_);
+    Eigen::Vector3d first_derivative = radius_ * (c * tangential_ - sn * radial_) + axial_rate_ * axis_;   // dp/dphi
+
+    task_way_point->kinematic.position = center_ + radius_vector + axial_rate_ * angle * axis_;
+    task_way_point->dynamic.linear.velocity = first_derivative * angular_velocity;
+    task_way_point->dynamic.linear.acceleration = -radius_vector * angular_velocity * angular_velocity + first_derivative * angular_acceleration;
+  }
+  task_way_point->kinematic.orientation = orientation_;
+  task_way_point->dynamic.angular.velocity = Eigen::Vector3d::Zero();
+  task_way_point->dynamic.angular.acceleration = Eigen::Vector3d::Zero();
 }
 
 
 /*****************************************************************************
 ** Trajectory Class
 *****************************************************************************/
+Trajectory::Trajectory()
+  : trajectory_type_(NONE),
+    tick_time_(0.0),
+    speed_override_(1.0),
+    speed_override_goal_(1.0),
+    speed_override_ramp_rate_(0.0),
+    speed_override_applied_(false),
+    joint_segment_(1),
+    task_segment_(1),
+    segment_start_time_(1, 0.0),
+    present_segment_index_(0),
+    orientation_interpolation_(RPY_INTERPOLATION)
+{
+  trajectory_time_.total_move_time = 0.0;
+  trajectory_time_.present_time = 0.0;
+  trajectory_time_.start_time = 0.0;
+}
+
+Trajectory::Trajectory(const Trajectory &trajectory)
+  : trajectory_type_(trajectory.trajectory_type_),
+    trajectory_time_(trajectory.trajectory_time_),
+    tick_time_(trajectory.tick_time_),
+    speed_override_(trajectory.speed_override_.load()),
+    speed_override_goal_(trajectory.speed_override_goal_.load()),
+    speed_override_ramp_rate_(trajectory.speed_override_ramp_rate_.load()),
+    speed_override_applied_(trajectory.speed_override_applied_),
+    manipulator_(trajectory.manipulator_),
+    joint_segment_(trajectory.joint_segment_),
+    task_segment_(trajectory.task_segment_),
+    segment_start_time_(trajectory.segment_start_time_),
+    present_segment_index_(trajectory.present_segment_index_),
+    orientation_interpolation_(trajectory.orientation_interpolation_),
+    joint_s_curve_(trajectory.joint_s_curve_),
+    task_path_(trajectory.task_path_),
+    cus_joint_(trajectory.cus_joint_),
+    cus_task_(trajectory.cus_task_),
+    present_custom_trajectory_name_(trajectory.present_custom_trajectory_name_),
+    present_control_tool_name_(trajectory.present_control_tool_name_)
+{}
+
+Trajectory &Trajectory::operator=(const Trajectory &trajectory)
+{
+  if (this == &trajectory)
+    return *this;
+  trajectory_type_ = trajectory.trajectory_type_;
+  trajectory_time_ = trajectory.trajectory_time_;
+  tick_time_ = trajectory.tick_time_;
+  speed_override_.store(trajectory.speed_override_.load());
+  speed_override_goal_.store(trajectory.speed_override_goal_.load());
+  speed_override_ramp_rate_.store(trajectory.speed_override_ramp_rate_.load());
+  speed_override_applied_ = trajectory.speed_override_applied_;
+  manipulator_ = trajectory.manipulator_;
+  joint_segment_ = trajectory.joint_segment_;
+  task_segment_ = trajectory.task_segment_;
+  segment_start_time_ = trajectory.segment_start_time_;
+  present_segment_index_ = trajectory.present_segment_index_;
+  orientation_interpolation_ = trajectory.orientation_interpolation_;
+  joint_s_curve_ = trajectory.joint_s_curve_;
+  task_path_ = trajectory.task_path_;
+  cus_joint_ = trajectory.cus_joint_;
+  cus_task_ = trajectory.cus_task_;
+  present_custom_trajectory_name_ = trajectory.present_custom_trajectory_name_;
+  present_control_tool_name_ = trajectory.present_control_tool_name_;
+  return *this;
+}
+
 void Trajectory::setMoveTime(double move_time)
 {
   trajectory_time_.total_move_time = move_time;
@@ -275,17 +1118,54 @@ void Trajectory::setMoveTime(double move_time)
 
 void Trajectory::setPresentTime(double present_time)
 {
+  double delta_time = present_time - trajectory_time_.present_time;
   trajectory_time_.present_time = present_time;
+  if (delta_time <= 0.0)
+    return;
+
+  // The ramp rate is stored before the goal, so a new goal always comes with its ramp rate
+  const double speed_override_goal = speed_override_goal_.load();
+  const double speed_override_ramp_rate = speed_override_ramp_rate_.load();
+  double previous_speed_override = speed_override_.load();
+  double speed_override = previous_speed_override;
+  if (speed_override != speed_override_goal)
+  {
+    double max_step = speed_override_ramp_rate * delta_time;
+    if (speed_override_ramp_rate <= 0.0)
+      previous_speed_override = speed_override = speed_override_goal;
+    else if (fabs(speed_override_goal - speed_override) <= max_step)
+      speed_override = speed_override_goal;
+    else if (speed_override_goal > speed_override)
+      speed_override += max_step;
+    else
+      speed_override -= max_step;
+    speed_override_.store(speed_override);
+  }
+
+  // Present minus start only while no other speed was used, otherwise the time integrated at that speed is kept
+  if (!speed_override_applied_ && previous_speed_override == 1.0 && speed_override == 1.0)
+  {
+    tick_time_ = trajectory_time_.present_time - trajectory_time_.start_time;
+  }
+  else
+  {
+    tick_time_ += 0.5 * (previous_speed_override + speed_override) * delta_time;
+    speed_override_applied_ = true;
+  }
 }
 
 void Trajectory::setStartTimeToPresentTime()
 {
   trajectory_time_.start_time = trajectory_time_.present_time;
+  tick_time_ = 0.0;
+  speed_override_applied_ = false;
 }
 
 void Trajectory::setStartTime(double start_time)
 {
   trajectory_time_.start_time = start_time;
+  tick_time_ = trajectory_time_.present_time - start_time;
+  speed_override_applied_ = false;
 }
 
 double Trajectory::getMoveTime()
@@ -295,10 +1175,188 @@ double Trajectory::getMoveTime()
 
 double Trajectory::getTickTime()
 {
-  return trajectory_time_.present_time - trajectory_time_.start_time;
+  return tick_time_;
+}
+
+void Trajectory::setSpeedOverride(double speed_override, double ramp_rate)
+{
+  speed_override_ramp_rate_.store(ramp_rate);
+  speed_override_goal_.store(std::min(std::max(speed_override, 0.0), 2.0));
+}
+
+double Trajectory::getSpeedOverride()
+{
+  return speed_override_.load();
+}
+
+void Trajectory::applySpeedOverride(JointWaypoint *joint_way_point)
+{
+  const double speed_override = speed_override_.load();
+  if (speed_override == 1.0)
+    return;
+  for (uint32_t index = 0; index < joint_way_point->size(); index++)
+  {
+    joint_way_point->at(index).velocity *= speed_override;
+    joint_way_point->at(index).acceleration *= speed_override * speed_override;
+  }
+}
+
+bool Trajectory::getJointExtremum(std::vector<Limit> *position, std::vector<Limit> *velocity) const
+{
+  Limit position_temp, velocity_temp;
+  if (trajectory_type_ == JOINT_TRAJECTORY)
+  {
+    position->clear();
+    velocity->clear();
+    for (uint32_t segment = 0; segment < joint_segment_.size(); segment++)
+    {
+      const JointTrajectory &joint_trajectory = joint_segment_.at(segment);
+      for (uint8_t index = 0; index < joint_trajectory.getSize(); index++)
+      {
+        joint_trajectory.getJointExtremum(index, &position_temp, &velocity_temp);
+        if (segment == 0)
+        {
+          position->push_back(position_temp);
+          velocity->push_back(velocity_temp);
+          continue;
+        }
+        position->at(index).maximum = std::max(position->at(index).maximum, position_temp.maximum);
+        position->at(index).minimum = std::min(position->at(index).minimum, position_temp.minimum);
+        velocity->at(index).maximum = std::max(velocity->at(index).maximum, velocity_temp.maximum);
+        velocity->at(index).minimum = std::min(velocity->at(index).minimum, velocity_temp.minimum);
+      }
+    }
+    return true;
+  }
+  else if (trajectory_type_ == JOINT_S_CURVE_TRAJECTORY)
+  {
+    position->resize(joint_s_curve_.getSize());
+    velocity->resize(joint_s_curve_.getSize());
+    for (uint8_t index = 0; index < joint_s_curve_.getSize(); index++)
+      joint_s_curve_.getJointExtremum(index, &position->at(index), &velocity->at(index));
+    return true;
+  }
+  return false;
+}
+
+bool Trajectory::sampleJointWaypoint(const Eigen::Ref<const Eigen::VectorXd> &tick,
+                                     Eigen::MatrixXd *position,
+                                     Eigen::MatrixXd *velocity,
+                                     Eigen::MatrixXd *acceleration) const
+{
+  if (trajectory_type_ == JOINT_TRAJECTORY)
+  {
+    if (joint_segment_.size() == 1)
+    {
+      // Ticks are ascending, so only a last tick past the end needs a clamped copy
+      if (tick.size() > 0 && tick(tick.size() - 1) > trajectory_time_.total_move_time)
+        joint_segment_.at(0).sampleJointWaypoint(tick.cwiseMin(trajectory_time_.total_move_time), position, velocity, acceleration);
+      else
+        joint_segment_.at(0).sampleJointWaypoint(tick, position, velocity, acceleration);
+      return true;
+    }
+
+    // Split the ticks into runs of the same segment
+    Eigen::MatrixXd segment_position, segment_velocity, segment_acceleration;
+    Eigen::Index begin = 0;
+    while (begin < tick.size())
+    {
+      uint32_t segment;
+      Eigen::Index end = findSegmentRun(segment_start_time_, tick, begin, &segment);
+      double segment_start_time = segment_start_time_.at(segment);
+
+      Eigen::VectorXd segment_tick = tick.segment(begin, end - begin).array() - segment_start_time;
+      if (segment + 1 == segment_start_time_.size())
+        segment_tick = segment_tick.cwiseMin(trajectory_time_.total_move_time - segment_start_time);
+      joint_segment_.at(segment).sampleJointWaypoint(segment_tick,
+                                                     position != nullptr ? &segment_position : nullptr,
+                                                     velocity != nullptr ? &segment_velocity : nullptr,
+                                                     acceleration != nullptr ? &segment_acceleration : nullptr);
+      if (position != nullptr)
+      {
+        if (begin == 0) position->resize(tick.size(), segment_position.cols());
+        position->middleRows(begin, end - begin) = segment_position;
+      }
+      if (velocity != nullptr)
+      {
+        if (begin == 0) velocity->resize(tick.size(), segment_velocity.cols());
+        velocity->middleRows(begin, end - begin) = segment_velocity;
+      }
+      if (acceleration != nullptr)
+      {
+        if (begin == 0) acceleration->resize(tick.size(), segment_acceleration.cols());
+        acceleration->middleRows(begin, end - begin) = segment_acceleration;
+      }
+      begin = end;
+    }
+    return true;
+  }
+  else if (trajectory_type_ == JOINT_S_CURVE_TRAJECTORY)
+  {
+    joint_s_curve_.sampleJointWaypoint(tick, position, velocity, acceleration);
+    return true;
+  }
+  else if (trajectory_type_ == CUSTOM_JOINT_TRAJECTORY && cus_joint_.find(present_custom_trajectory_name_) != cus_joint_.end())
+  {
+    cus_joint_.at(present_custom_trajectory_name_)->sampleJointWaypoint(tick, position, velocity, acceleration);
+    return true;
+  }
+  log::error("[sampleJointWaypoint] Present trajectory is not a joint trajectory.");
+  return false;
+}
+
+bool Trajectory::sampleTaskWaypoint(const Eigen::Ref<const Eigen::VectorXd> &tick, std::vector<TaskWaypoint> *task_way_point) const
+{
+  if (trajectory_type_ == TASK_TRAJECTORY)
+  {
+    if (task_segment_.size() == 1)
+    {
+      if (tick.size() > 0 && tick(tick.size() - 1) > trajectory_time_.total_move_time)
+        task_segment_.at(0).sampleTaskWaypoint(tick.cwiseMin(trajectory_time_.total_move_time), task_way_point);
+      else
+        task_segment_.at(0).sampleTaskWaypoint(tick, task_way_point);
+      return true;
+    }
+
+    std::vector<TaskWaypoint> segment_way_point;
+    if (task_way_point->size() != static_cast<size_t>(tick.size()))
+      task_way_point->resize(tick.size());
+
+    Eigen::Index begin = 0;
+    while (begin < tick.size())
+    {
+      uint32_t segment;
+      Eigen::Index end = findSegmentRun(segment_start_time_, tick, begin, &segment);
+      double segment_start_time = segment_start_time_.at(segment);
+
+      Eigen::VectorXd segment_tick = tick.segment(begin, end - begin).array() - segment_start_time;
+      if (segment + 1 == segment_start_time_.size())
+        segment_tick = segment_tick.cwiseMin(trajectory_time_.total_move_time - segment_start_time);
+      task_segment_.at(segment).sampleTaskWaypoint(segment_tick, &segment_way_point);
+      std::copy(segment_way_point.begin(), segment_way_point.end(), task_way_point->begin() + begin);
+      begin = end;
+    }
+    return true;
+  }
+  else if (trajectory_type_ == TASK_PATH_TRAJECTORY)
+  {
+    // The path clamps the tick to its move time itself
+    if (task_way_point->size() != static_cast<size_t>(tick.size()))
+      task_way_point->resize(tick.size());
+    for (Eigen::Index index = 0; index < tick.size(); index++)
+      task_path_.getTaskWaypoint(tick(index), &task_way_point->at(index));
+    return true;
+  }
+  else if (trajectory_type_ == CUSTOM_TASK_TRAJECTORY && cus_task_.find(present_custom_trajectory_name_) != cus_task_.end())
+  {
+    cus_task_.at(present_custom_trajectory_name_)->sampleTaskWaypoint(tick, task_way_point);
+    return true;
+  }
+  log::error("[sampleTaskWaypoint] Present trajectory is not a task trajectory.");
+  return false;
 }
 
-void Trajectory::setManipulator(Manipulator manipulator)
+void Trajectory::setManipulator(const Manipulator &manipulator)
 {
   manipulator_= manipulator;
 }
@@ -308,14 +1366,70 @@ Manipulator* Trajectory::getManipulator()
   return &manipulator_;
 }
 
-JointTrajectory Trajectory::getJointTrajectory()
+uint32_t Trajectory::getSegmentSize()
+{
+  return segment_start_time_.size();
+}
+
+uint32_t Trajectory::getPresentSegmentIndex()
+{
+  return present_segment_index_;
+}
+
+double Trajectory::updatePresentSegment(double tick_time)
+{
+  if (present_segment_index_ >= segment_start_time_.size() || tick_time < segment_start_time_.at(present_segment_index_))
+    present_segment_index_ = 0;
+
+  while (present_segment_index_ + 1 < segment_start_time_.size() && tick_time >= segment_start_time_.at(present_segment_index_ + 1))
+    present_segment_index_++;
+
+  return tick_time - segment_start_time_.at(present_segment_index_);
+}
+
+bool Trajectory::getTaskWaypoint(double tick_time, TaskWaypoint *task_way_point)
+{
+  if (trajectory_type_ == TASK_TRAJECTORY)
+  {
+    double segment_tick_time = updatePresentSegment(tick_time);
+    *task_way_point = getTaskTrajectory().getTaskWaypoint(segment_tick_time);
+    return true;
+  }
+  else if (trajectory_type_ == TASK_PATH_TRAJECTORY)
+  {
+    task_path_.getTaskWaypoint(tick_time, task_way_point);
+    return true;
+  }
+  else if (trajectory_type_ == CUSTOM_TASK_TRAJECTORY && cus_task_.find(present_custom_trajectory_name_) != cus_task_.end())
+  {
+    *task_way_point = cus_task_.at(present_custom_trajectory_name_)->getTaskWaypoint(tick_time);
+    return true;
+  }
+  return false;
+}
+
+JointTrajectory &Trajectory::getJointTrajectory()
+{
+  if (present_segment_index_ < joint_segment_.size())
+    return joint_segment_.at(present_segment_index_);
+  return joint_segment_.back();
+}
+
+TaskTrajectory &Trajectory::getTaskTrajectory()
 {
-  return joint_;
+  if (present_segment_index_ < task_segment_.size())
+    return task_segment_.at(present_segment_index_);
+  return task_segment_.back();
 }
 
-TaskTrajectory Trajectory::getTaskTrajectory()
+JointSCurveTrajectory &Trajectory::getJointSCurveTrajectory()
 {
-  return task_;
+  return joint_s_curve_;
+}
+
+TaskPathTrajectory &Trajectory::getTaskPathTrajectory()
+{
+  return task_path_;
 }
 
 CustomJointTrajectory *Trajectory::getCustomJointTrajectory(Name name)
@@ -361,7 +1475,7 @@ Name Trajectory::getPresentControlToolName()
  return present_control_tool_name_;
 }
 
-void Trajectory::initTrajectoryWaypoint(Manipulator actual_manipulator, Kinematics *kinematics)
+void Trajectory::initTrajectoryWaypoint(const Manipulator &actual_manipulator, Kinematics *kinematics)
 {
   setManipulator(actual_manipulator);
   JointWaypoint joint_way_point_vector;
@@ -375,7 +1489,7 @@ void Trajectory::initTrajectoryWaypoint(Manipulator actual_manipulator, Kinemati
 void Trajectory::updatePresentWaypoint(Kinematics *kinematics)
 {
   //kinematics
-  kinematics->solveForwardKinematics(&manipulator_);
+  kinematics->updateForwardKinematics(&manipulator_);
 }
 
 void Trajectory::setPresentJointWaypoint(JointWaypoint joint_value_vector)
@@ -425,6 +1539,11 @@ void Trajectory::setTrajectoryType(TrajectoryType trajectory_type)
   trajectory_type_ = trajectory_type;
 }
 
+void Trajectory::setOrientationInterpolation(OrientationInterpolation orientation_interpolation)
+{
+  orientation_interpolation_ = orientation_interpolation;
+}
+
 bool Trajectory::checkTrajectoryType(TrajectoryType trajectory_type)
 {
   if(trajectory_type_==trajectory_type)
@@ -435,12 +1554,193 @@ bool Trajectory::checkTrajectoryType(TrajectoryType trajectory_type)
 
 bool Trajectory::makeJointTrajectory(JointWaypoint start_way_point, JointWaypoint goal_way_point)
 {
-  return joint_.makeJointTrajectory(trajectory_time_.total_move_time, start_way_point, goal_way_point);
+  joint_segment_.resize(1);
+  segment_start_time_.assign(1, 0.0);
+  present_segment_index_ = 0;
+  return joint_segment_.at(0).makeJointTrajectory(trajectory_time_.total_move_time, start_way_point, goal_way_point);
+}
+
+bool Trajectory::makeJointTrajectory(JointWaypoint start_way_point, std::vector<JointWaypoint> via_way_point, std::vector<double> move_time)
+{
+  if (via_way_point.size() == 0 || via_way_point.size() != move_time.size())
+  {
+    log::error("[makeJointTrajectory] Wrong via point size.");
+    return false;
+  }
+  for (uint32_t index = 0; index < via_way_point.size(); index++)
+  {
+    if (via_way_point.at(index).size() != start_way_point.size() || move_time.at(index) <= 0.0)
+    {
+      log::error("[makeJointTrajectory] Wrong via point.");
+      return false;
+    }
+  }
+
+  // blend the intermediate points so that neighbouring segments join without stopping
+  for (uint32_t index = 0; index + 1 < via_way_point.size(); index++)
+  {
+    const JointWaypoint &previous = (index == 0) ? start_way_point : via_way_point.at(index - 1);
+    const JointWaypoint &next = via_way_point.at(index + 1);
+    JointWaypoint &via = via_way_point.at(index);
+    for (uint32_t joint = 0; joint < via.size(); joint++)
+    {
+      via.at(joint).velocity = calcViaPointVelocity(previous.at(joint).position,
+                                                    via.at(joint).position,
+                                                    next.at(joint).position,
+                                                    move_time.at(index),
+                                                    move_time.at(index + 1));
+      via.at(joint).acceleration = 0.0;
+    }
+  }
+
+  joint_segment_.resize(via_way_point.size());
+  segment_start_time_.resize(via_way_point.size());
+  present_segment_index_ = 0;
+
+  double start_time = 0.0;
+  for (uint32_t index = 0; index < via_way_point.size(); index++)
+  {
+    const JointWaypoint &start = (index == 0) ? start_way_point : via_way_point.at(index - 1);
+    segment_start_time_.at(index) = start_time;
+    if (!joint_segment_.at(index).makeJointTrajectory(move_time.at(index), start, via_way_point.at(index)))
+      return false;
+    start_time += move_time.at(index);
+  }
+  trajectory_time_.total_move_time = start_time;
+  return true;
+}
+
+bool Trajectory::makeJointSCurveTrajectory(JointWaypoint start_way_point,
+                                           JointWaypoint goal_way_point,
+                                           std::vector<double> max_velocity,
+                                           std::vector<double> max_acceleration,
+                                           std::vector<double> max_jerk)
+{
+  if (!joint_s_curve_.makeJointTrajectory(start_way_point, goal_way_point, max_velocity, max_acceleration, max_jerk))
+    return false;
+  trajectory_time_.total_move_time = joint_s_curve_.getMoveTime();
+  return true;
 }
 
 bool Trajectory::makeTaskTrajectory(TaskWaypoint start_way_point, TaskWaypoint goal_way_point)
 {
-  return task_.makeTaskTrajectory(trajectory_time_.total_move_time, start_way_point, goal_way_point);
+  task_segment_.resize(1);
+  segment_start_time_.assign(1, 0.0);
+  present_segment_index_ = 0;
+  task_segment_.at(0).setOrientationInterpolation(orientation_interpolation_);
+  return task_segment_.at(0).makeTaskTrajectory(trajectory_time_.total_move_time, start_way_point, goal_way_point);
+}
+
+bool Trajectory::makeTaskTrajectory(TaskWaypoint start_way_point, std::vector<TaskWaypoint> via_way_point, std::vector<double> move_time)
+{
+  if (via_way_point.size() == 0 || via_way_point.size() != move_time.size())
+  {
+    log::error("[makeTaskTrajectory] Wrong via point size.");
+    return false;
+  }
+  for (uint32_t index = 0; index < move_time.size(); index++)
+  {
+    if (move_time.at(index) <= 0.0)
+    {
+      log::error("[makeTaskTrajectory] Wrong move time.");
+      return false;
+    }
+  }
+
+  // blend the intermediate points so that neighbouring segments join without stopping
+  for (uint32_t index = 0; index + 1 < via_way_point.size(); index++)
+  {
+    const TaskWaypoint &previous = (index == 0) ? start_way_point : via_way_point.at(index - 1);
+    const TaskWaypoint &next = via_way_point.at(index + 1);
+    TaskWaypoint &via = via_way_point.at(index);
+
+    Eigen::Vector3d previous_rpy = math::convertRotationMatrixToRPYVector(previous.kinematic.orientation);
+    Eigen::Vector3d via_rpy = math::convertRotationMatrixToRPYVector(via.kinematic.orientation);
+    Eigen::Vector3d next_rpy = math::convertRotationMatrixToRPYVector(next.kinematic.orientation);
+    Eigen::Vector3d rpy_velocity;
+
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+      previous_rpy[axis] = unwrapAngle(previous_rpy[axis], via_rpy[axis]);
+      next_rpy[axis] = unwrapAngle(next_rpy[axis], via_rpy[axis]);
+      via.dynamic.linear.velocity[axis] = calcViaPointVelocity(previous.kinematic.position[axis],
+                                                               via.kinematic.position[axis],
+                                                               next.kinematic.position[axis],
+                                                               move_time.at(index),
+                                                               move_time.at(index + 1));
+      rpy_velocity[axis] = calcViaPointVelocity(previous_rpy[axis],
+                                                via_rpy[axis],
+                                                next_rpy[axis],
+                                                move_time.at(index),
+                                                move_time.at(index + 1));
+    }
+    if (orientation_interpolation_ == SLERP_INTERPOLATION)
+      via.dynamic.angular.velocity = calcSlerpViaPointVelocity(previous.kinematic.orientation,
+                                                               via.kinematic.orientation,
+                                                               next.kinematic.orientation,
+                                                               move_time.at(index),
+                                                               move_time.at(index + 1));
+    else
+      via.dynamic.angular.velocity = math::convertRPYVelocityToOmega(via_rpy, rpy_velocity);
+    via.dynamic.linear.acceleration = Eigen::Vector3d::Zero();
+    via.dynamic.angular.acceleration = Eigen::Vector3d::Zero();
+  }
+
+  task_segment_.resize(via_way_point.size());
+  segment_start_time_.resize(via_way_point.size());
+  present_segment_index_ = 0;
+
+  double start_time = 0.0;
+  for (uint32_t index = 0; index < via_way_point.size(); index++)
+  {
+    const TaskWaypoint &start = (index == 0) ? start_way_point : via_way_point.at(index - 1);
+    segment_start_time_.at(index) = start_time;
+    task_segment_.at(index).setOrientationInterpolation(orientation_interpolation_);
+    if (!task_segment_.at(index).makeTaskTrajectory(move_time.at(index), start, via_way_point.at(index)))
+      return false;
+    start_time += move_time.at(index);
+  }
+  trajectory_time_.total_move_time = start_time;
+  return true;
+}
+
+bool Trajectory::makeJointSplineTrajectory(std::vector<JointWaypoint> knot_way_point, std::vector<double> knot_time)
+{
+  if (knot_way_point.size() < 2 || knot_way_point.size() != knot_time.size())
+  {
+    log::error("[makeJointSplineTrajectory] Wrong knot size.");
+    return false;
+  }
+  for (uint32_t index = 1; index < knot_time.size(); index++)
+  {
+    if (knot_time.at(index) <= knot_time.at(index - 1))
+    {
+      log::error("[makeJointSplineTrajectory] Knot time should be increasing.");
+      return false;
+    }
+  }
+
+  joint_segment_.resize(knot_way_point.size() - 1);
+  segment_start_time_.resize(knot_way_point.size() - 1);
+  present_segment_index_ = 0;
+  for (uint32_t index = 0; index + 1 < knot_way_point.size(); index++)
+  {
+    segment_start_time_.at(index) = knot_time.at(index) - knot_time.front();
+    if (!joint_segment_.at(index).makeJointTrajectory(knot_time.at(index + 1) - knot_time.at(index), knot_way_point.at(index), knot_way_point.at(index + 1)))
+      return false;
+  }
+  trajectory_time_.total_move_time = knot_time.back() - knot_time.front();
+  return true;
+}
+
+bool Trajectory::makeTaskLineTrajectory(TaskWaypoint start_way_point, Eigen::Vector3d goal_position)
+{
+  return task_path_.makeLineTrajectory(trajectory_time_.total_move_time, start_way_point, goal_position);
+}
+
+bool Trajectory::makeTaskHelixTrajectory(TaskWaypoint start_way_point, Eigen::Vector3d center, Eigen::Vector3d axis, double angle, double pitch)
+{
+  return task_path_.makeHelixTrajectory(trajectory_time_.total_move_time, start_way_point, center, axis, angle, pitch);
 }
 
 bool Trajectory::makeCustomTrajectory(Name trajectory_name, JointWaypoint start_way_point, const void *arg)
@@ -0,0 +1,123 @@
+/*******************************************************************************
+* Copyright 2018 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/* Authors: Darby Lim, Hye-Jong KIM, Ryan Shim, Yong-Ho Na */
+
+// Microbenchmark of JointTrajectory::getJointWaypoint for 4, 6 and 7 DOF chains, against the pow() evaluation
+// into a new JointWaypoint that it replaced. Build with -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+
+#include <chrono>
+#include <cstdio>
+
+#include "../include/robotis_manipulator/robotis_manipulator.h"
+
+using namespace robotis_manipulator;
+
+namespace
+{
+const int CALL_SIZE = 1000000;
+const double MOVE_TIME = 2.0;
+const double CONTROL_PERIOD = 0.001;
+
+// Evaluation before the Horner form: a new waypoint and pow() for every power of tick
+JointWaypoint getPowerJointWaypoint(const Eigen::MatrixXd &coefficient, double tick)
+{
+  JointWaypoint joint_way_point;
+  for (int index = 0; index < coefficient.cols(); index++)
+  {
+    JointValue joint_value;
+    joint_value.position = coefficient(0, index) + coefficient(1, index) * pow(tick, 1) + coefficient(2, index) * pow(tick, 2) +
+                           coefficient(3, index) * pow(tick, 3) + coefficient(4, index) * pow(tick, 4) + coefficient(5, index) * pow(tick, 5);
+    joint_value.velocity = coefficient(1, index) + 2 * coefficient(2, index) * pow(tick, 1) + 3 * coefficient(3, index) * pow(tick, 2) +
+                           4 * coefficient(4, index) * pow(tick, 3) + 5 * coefficient(5, index) * pow(tick, 4);
+    joint_value.acceleration = 2 * coefficient(2, index) + 6 * coefficient(3, index) * pow(tick, 1) +
+                               12 * coefficient(4, index) * pow(tick, 2) + 20 * coefficient(5, index) * pow(tick, 3);
+    joint_value.effort = 0.0;
+    joint_way_point.push_back(joint_value);
+  }
+  return joint_way_point;
+}
+
+double tickTime(int call)
+{
+  return (call % static_cast<int>(MOVE_TIME / CONTROL_PERIOD)) * CONTROL_PERIOD;
+}
+
+double elapsedNanoseconds(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CALL_SIZE;
+}
+} // namespace
+
+int main()
+{
+  const int joint_size[3] = {4, 6, 7};
+  volatile double sink = 0.0;
+
+  std::printf("dof  max difference  pow [ns]  by value [ns]  buffer [ns]  speedup\n");
+  for (int chain = 0; chain < 3; chain++)
+  {
+    JointWaypoint start(joint_size[chain]), goal(joint_size[chain]);
+    for (int index = 0; index < joint_size[chain]; index++)
+    {
+      start.at(index).position = 0.1 * index;
+      start.at(index).velocity = 0.2;
+      start.at(index).acceleration = 0.1;
+      goal.at(index).position = 1.0 - 0.3 * index;
+    }
+    JointTrajectory joint_trajectory;
+    joint_trajectory.makeJointTrajectory(MOVE_TIME, start, goal);
+    const Eigen::MatrixXd coefficient = joint_trajectory.getMinimumJerkCoefficient();
+
+    // Both evaluations give the same waypoints
+    double difference = 0.0;
+    JointWaypoint joint_way_point;
+    for (int call = 0; call <= MOVE_TIME / CONTROL_PERIOD; call++)
+    {
+      const double tick = call * CONTROL_PERIOD;
+      const JointWaypoint power_way_point = getPowerJointWaypoint(coefficient, tick);
+      joint_trajectory.getJointWaypoint(tick, &joint_way_point);
+      for (int index = 0; index < joint_size[chain]; index++)
+      {
+        difference = std::max(difference, std::fabs(power_way_point.at(index).position - joint_way_point.at(index).position));
+        difference = std::max(difference, std::fabs(power_way_point.at(index).velocity - joint_way_point.at(index).velocity));
+        difference = std::max(difference, std::fabs(power_way_point.at(index).acceleration - joint_way_point.at(index).acceleration));
+      }
+    }
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    for (int call = 0; call < CALL_SIZE; call++)
+      sink = sink + getPowerJointWaypoint(coefficient, tickTime(call)).at(0).position;
+    const double power_time = elapsedNanoseconds(start_time);
+
+    start_time = std::chrono::steady_clock::now();
+    for (int call = 0; call < CALL_SIZE; call++)
+      sink = sink + joint_trajectory.getJointWaypoint(tickTime(call)).at(0).position;
+    const double value_time = elapsedNanoseconds(start_time);
+
+    start_time = std::chrono::steady_clock::now();
+    for (int call = 0; call < CALL_SIZE; call++)
+    {
+      joint_trajectory.getJointWaypoint(tickTime(call), &joint_way_point);
+      sink = sink + joint_way_point.at(0).position;
+    }
+    const double buffer_time = elapsedNanoseconds(start_time);
+
+    std::printf("%3d  %14.1e  %8.1f  %13.1f  %11.1f  %6.1fx\n",
+                joint_size[chain], difference, power_time, value_time, buffer_time, power_time / buffer_time);
+  }
+  return 0;
+}
@@ -0,0 +1,150 @@
+/*******************************************************************************
+* Copyright 2018 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/* Authors: Darby Lim, Hye-Jong KIM, Ryan Shim, Yong-Ho Na */
+
+// Actuator ID table and route of RobotisManipulator after the model is edited behind its back.
+
+#include <gtest/gtest.h>
+
+#include "test_robot.h"
+
+using namespace robotis_manipulator;
+
+namespace
+{
+// Answers every ID with position ID / 100 and keeps what it was sent
+class FakeJointActuator : public JointActuator
+{
+public:
+  std::vector<uint8_t> id_;
+  std::map<uint8_t, ActuatorValue> sent_;
+
+  virtual void init(std::vector<uint8_t> actuator_id, const void *arg) { id_ = actuator_id; }
+  virtual void setMode(std::vector<uint8_t> actuator_id, const void *arg) {}
+  virtual std::vector<uint8_t> getId() { return id_; }
+
+  virtual void enable() { enabled_state_ = true; }
+  virtual void disable() { enabled_state_ = false; }
+
+  virtual bool sendJointActuatorValue(std::vector<uint8_t> actuator_id, std::vector<ActuatorValue> value_vector)
+  {
+    for (uint32_t index = 0; index < actuator_id.size(); index++)
+      sent_[actuator_id.at(index)] = value_vector.at(index);
+    return true;
+  }
+  virtual std::vector<ActuatorValue> receiveJointActuatorValue(std::vector<uint8_t> actuator_id)
+  {
+    std::vector<ActuatorValue> value_vector(actuator_id.size());
+    for (uint32_t index = 0; index < actuator_id.size(); index++)
+      value_vector.at(index).position = actuator_id.at(index) / 100.0;
+    return value_vector;
+  }
+};
+
+class ActuatorTableTest : public testing::Test
+{
+protected:
+  RobotisManipulator robot_;
+  FakeJointActuator actuator_;
+
+  // joint1 -> joint2 -> tool_a, both joints driven by one actuator
+  virtual void SetUp()
+  {
+    robot_.addWorld("world", "joint1");
+    robot_.addJoint("joint1", "world", "joint2", math::vector3(0.0, 0.0, 0.1), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), math::vector3(0.0, 0.0, 1.0), 11);
+    robot_.addJoint("joint2", "joint1", "tool_a", math::vector3(0.0, 0.0, 0.1), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), math::vector3(0.0, 1.0, 0.0), 12);
+    robot_.addTool("tool_a", "joint2", math::vector3(0.2, 0.0, 0.0), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), 14);
+    robot_.addJointActuator("joint", &actuator_, std::vector<uint8_t>{11, 12}, NULL);
+  }
+
+  // A joint whose name sorts between joint1 and joint2 takes the active slot joint2 had
+  void addJointBeforeJoint2()
+  {
+    robot_.addJoint("joint1b", "joint1", "tool_b", math::vector3(0.1, 0.0, 0.1), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), math::vector3(1.0, 0.0, 0.0), 13);
+    robot_.addComponentChild("joint1", "joint1b");
+    robot_.addTool("tool_b", "joint1b", math::vector3(0.0, 0.2, 0.0), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), 15);
+  }
+
+  void setCoefficient(Name joint_name, double coefficient)
+  {
+    Component component = robot_.getManipulator()->getComponent(joint_name);
+    component.joint_constant.coefficient = coefficient;
+    robot_.getManipulator()->setComponent(joint_name, component);
+  }
+};
+} // namespace
+
+TEST_F(ActuatorTableTest, ReceiveFollowsAJointAddedAfterTheActuator)
+{
+  robot_.receiveAllJointActuatorValue();
+  addJointBeforeJoint2();
+  robot_.getManipulator()->setJointPosition("joint1b", 0.5);
+
+  robot_.receiveAllJointActuatorValue();
+  EXPECT_DOUBLE_EQ(robot_.getManipulator()->getJointPosition("joint1"), 0.11);
+  EXPECT_DOUBLE_EQ(robot_.getManipulator()->getJointPosition("joint1b"), 0.5);
+  EXPECT_DOUBLE_EQ(robot_.getManipulator()->getJointPosition("joint2"), 0.12);
+
+  std::vector<JointValue> result = robot_.receiveMultipleJointActuatorValue(std::vector<Name>{"joint2"});
+  ASSERT_EQ(result.size(), 1u);
+  EXPECT_DOUBLE_EQ(result.at(0).position, 0.12);
+}
+
+TEST_F(ActuatorTableTest, ReceiveFollowsACoefficientSetThroughTheManipulator)
+{
+  robot_.receiveAllJointActuatorValue();
+  setCoefficient("joint2", 2.0);
+
+  robot_.receiveAllJointActuatorValue();
+  EXPECT_DOUBLE_EQ(robot_.getManipulator()->getJointPosition("joint1"), 0.11);
+  EXPECT_DOUBLE_EQ(robot_.getManipulator()->getJointPosition("joint2"), 0.24);
+}
+
+TEST_F(ActuatorTableTest, SendFollowsAJointAddedAfterTheActuator)
+{
+  robot_.sendAllJointActuatorValue(std::vector<JointValue>(2));
+  addJointBeforeJoint2();
+
+  // Active slots are joint1, joint1b, joint2 now
+  std::vector<JointValue> value_vector(3);
+  value_vector.at(0).position = 0.1;
+  value_vector.at(1).position = 0.2;
+  value_vector.at(2).position = 0.3;
+  ASSERT_TRUE(robot_.sendAllJointActuatorValue(value_vector));
+  EXPECT_DOUBLE_EQ(actuator_.sent_[11].position, 0.1);
+  EXPECT_DOUBLE_EQ(actuator_.sent_[12].position, 0.3);
+  EXPECT_EQ(actuator_.sent_.count(13), 0u);
+}
+
+TEST_F(ActuatorTableTest, SendFollowsACoefficientSetThroughTheManipulator)
+{
+  robot_.sendAllJointActuatorValue(std::vector<JointValue>(2));
+  setCoefficient("joint2", 2.0);
+
+  std::vector<JointValue> value_vector(2);
+  value_vector.at(0).position = 0.1;
+  value_vector.at(1).position = 0.3;
+  ASSERT_TRUE(robot_.sendAllJointActuatorValue(value_vector));
+  EXPECT_DOUBLE_EQ(actuator_.sent_[11].position, 0.1);
+  EXPECT_DOUBLE_EQ(actuator_.sent_[12].position, 0.15);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
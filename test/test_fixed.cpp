@@ -0,0 +1,114 @@
+/*******************************************************************************
+* Copyright 2018 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/* Authors: Darby Lim, Hye-Jong KIM, Ryan Shim, Yong-Ho Na */
+
+// Fixed-DOF fast path of robotis_manipulator_fixed.h against the dynamic-size API.
+
+#include <gtest/gtest.h>
+
+#include "../include/robotis_manipulator/robotis_manipulator_fixed.h"
+#include "../include/robotis_manipulator/robotis_manipulator_kinematics.h"
+#include "test_robot.h"
+
+using namespace robotis_manipulator;
+
+namespace
+{
+const double MOVE_TIME = 1.7;
+
+JointWaypoint makeJointWaypoint(double position, double velocity, double acceleration)
+{
+  JointWaypoint joint_way_point(6);
+  for (uint8_t index = 0; index < joint_way_point.size(); index++)
+  {
+    joint_way_point.at(index).position = position * (index + 1);
+    joint_way_point.at(index).velocity = velocity * (index + 1);
+    joint_way_point.at(index).acceleration = acceleration * (index + 1);
+    joint_way_point.at(index).effort = 0.0;
+  }
+  return joint_way_point;
+}
+} // namespace
+
+TEST(FixedTest, JointTrajectoryMatchesJointTrajectory)
+{
+  const JointWaypoint start = makeJointWaypoint(-0.2, 0.1, -0.3);
+  const JointWaypoint goal = makeJointWaypoint(0.4, -0.05, 0.2);
+
+  BasicJointTrajectory<double> joint_trajectory;
+  ASSERT_TRUE(joint_trajectory.makeJointTrajectory(MOVE_TIME, start, goal));
+
+  FixedJointWaypoint<6> fixed_start, fixed_goal;
+  ASSERT_TRUE(convertJointWaypoint(start, &fixed_start));
+  ASSERT_TRUE(convertJointWaypoint(goal, &fixed_goal));
+  FixedJointTrajectory<6> fixed_joint_trajectory;
+  ASSERT_TRUE(fixed_joint_trajectory.makeJointTrajectory(MOVE_TIME, fixed_start, fixed_goal));
+  EXPECT_LT((fixed_joint_trajectory.getMinimumJerkCoefficient() - joint_trajectory.getMinimumJerkCoefficient()).norm(), 1E-12);
+
+  FixedJointWaypoint<6> fixed_way_point;
+  JointWaypoint way_point;
+  for (double tick = 0.0; tick <= MOVE_TIME; tick += MOVE_TIME / 17.0)
+  {
+    fixed_joint_trajectory.getJointWaypoint(tick, &fixed_way_point);
+    joint_trajectory.getJointWaypoint(tick, &way_point);
+    for (uint8_t index = 0; index < 6; index++)
+    {
+      EXPECT_NEAR(fixed_way_point.position(index), way_point.at(index).position, 1E-12);
+      EXPECT_NEAR(fixed_way_point.velocity(index), way_point.at(index).velocity, 1E-12);
+      EXPECT_NEAR(fixed_way_point.acceleration(index), way_point.at(index).acceleration, 1E-12);
+    }
+  }
+}
+
+TEST(FixedTest, JacobianMatchesPoEJacobian)
+{
+  RobotisManipulator robot;
+  test::addSphericalWristArm(&robot);
+  Manipulator manipulator = *robot.getManipulator();
+  manipulator.setAllActiveJointPosition(std::vector<double>{0.3, -0.4, 0.7, 0.2, -0.5, 0.9});
+
+  PoEKinematics kinematics;
+  const Eigen::MatrixXd jacobian = kinematics.jacobian(&manipulator, "tool");
+  Eigen::Matrix<double, 6, 6> fixed_jacobian;
+  ASSERT_TRUE(math::fixedJacobian<6>(&manipulator, "tool", &fixed_jacobian));
+  EXPECT_LT((fixed_jacobian - jacobian).norm(), 1E-12);
+}
+
+TEST(FixedTest, JacobianOfABranchIsZeroForTheOtherBranch)
+{
+  RobotisManipulator robot;
+  test::addBranchedArm(&robot);
+  Manipulator manipulator = *robot.getManipulator();
+  manipulator.setAllActiveJointPosition(std::vector<double>{0.3, -0.4, 0.7});
+
+  PoEKinematics kinematics;
+  const Eigen::MatrixXd jacobian = kinematics.jacobian(&manipulator, "tool_a");
+  Eigen::Matrix<double, 6, 3> fixed_jacobian;
+  ASSERT_TRUE(math::fixedJacobian<3>(&manipulator, "tool_a", &fixed_jacobian));
+  EXPECT_LT((fixed_jacobian - jacobian).norm(), 1E-12);
+  EXPECT_EQ(fixed_jacobian.col(2).norm(), 0.0);
+  EXPECT_GT(fixed_jacobian.col(1).norm(), 0.1);
+
+  Eigen::Matrix<double, 6, 6> wrong_size_jacobian;
+  EXPECT_FALSE(math::fixedJacobian<6>(&manipulator, "tool_a", &wrong_size_jacobian));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
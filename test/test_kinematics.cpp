@@ -0,0 +1,579 @@
+/*******************************************************************************
+* Copyright 2018 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/* Authors: Darby Lim, Hye-Jong KIM, Ryan Shim, Yong-Ho Na */
+
+// Kinematics solvers of robotis_manipulator_kinematics.h and the forward kinematics update of Kinematics.
+
+#include <gtest/gtest.h>
+
+#include "../include/robotis_manipulator/robotis_manipulator_kinematics.h"
+#include "test_robot.h"
+
+using namespace robotis_manipulator;
+
+// The sanitizers replace malloc themselves
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#define COUNT_ALLOCATION
+#endif
+
+#if defined(COUNT_ALLOCATION)
+// Counts the heap allocations of the whole process while count_allocation is set, Eigen included
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t size, size_t element_size);
+extern "C" void *__libc_realloc(void *pointer, size_t size);
+
+namespace
+{
+bool count_allocation = false;
+size_t allocation_size = 0;
+} // namespace
+
+extern "C" void *malloc(size_t size)
+{
+  if (count_allocation) allocation_size++;
+  return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t size, size_t element_size)
+{
+  if (count_allocation) allocation_size++;
+  return __libc_calloc(size, element_size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size)
+{
+  if (count_allocation) allocation_size++;
+  return __libc_realloc(pointer, size);
+}
+#endif
+
+namespace
+{
+// Fills the linear velocity of the tool with the velocity of joint1, like a solver that also solves the dynamic poses
+class VelocityKinematics : public Kinematics
+{
+public:
+  int solve_count_;
+
+  VelocityKinematics() : solve_count_(0) {}
+  virtual void setOption(const void *arg) {}
+  virtual Eigen::MatrixXd jacobian(Manipulator *manipulator, Name tool_name) { return Eigen::MatrixXd(); }
+  virtual void solveForwardKinematics(Manipulator *manipulator)
+  {
+    solve_count_++;
+    DynamicPose dynamic_pose = manipulator->getComponentDynamicPoseFromWorld("tool");
+    dynamic_pose.linear.velocity = math::vector3(manipulator->getJointVelocity("joint1"), 0.0, 0.0);
+    manipulator->setComponentDynamicPoseFromWorld("tool", dynamic_pose);
+  }
+  virtual bool solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue> *goal_joint_position) { return false; }
+};
+
+class CountingPoEKinematics : public PoEKinematics
+{
+public:
+  int solve_count_;
+
+  CountingPoEKinematics() : solve_count_(0) {}
+  virtual void solveForwardKinematics(Manipulator *manipulator)
+  {
+    solve_count_++;
+    PoEKinematics::solveForwardKinematics(manipulator);
+  }
+};
+
+class CountingDampedLeastSquaresKinematics : public DampedLeastSquaresKinematics
+{
+public:
+  int solve_count_;
+
+  CountingDampedLeastSquaresKinematics() : solve_count_(0) {}
+  virtual bool solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue> *goal_joint_position)
+  {
+    solve_count_++;
+    return DampedLeastSquaresKinematics::solveInverseKinematics(manipulator, tool_name, target_pose, goal_joint_position);
+  }
+};
+
+class KinematicsTest : public testing::Test
+{
+protected:
+  RobotisManipulator robot_;
+  Manipulator manipulator_;
+
+  virtual void SetUp()
+  {
+    test::addSphericalWristArm(&robot_);
+    manipulator_ = *robot_.getManipulator();
+  }
+
+  // Tool poses of joint positions spread over the workspace
+  std::vector<Pose> makeTargetPose(size_t target_size)
+  {
+    PoEKinematics kinematics;
+    Manipulator manipulator = manipulator_;
+    std::vector<Pose> target_pose(target_size);
+    for (size_t target = 0; target < target_size; target++)
+    {
+      std::vector<double> joint_position(6);
+      for (uint8_t index = 0; index < 6; index++)
+        joint_position.at(index) = 0.8 * std::sin(1.3 * target + 0.7 * index + 0.1);
+      manipulator.setAllActiveJointPosition(joint_position);
+      kinematics.updateForwardKinematics(&manipulator);
+      target_pose.at(target).kinematic = manipulator.getComponentKinematicPoseFromWorld("tool");
+    }
+    return target_pose;
+  }
+};
+
+// Central differences of the tool pose, one column per active joint
+Eigen::MatrixXd calcNumericalJacobian(Manipulator manipulator, Name tool_name)
+{
+  const double step = 1E-6;
+  PoEKinematics kinematics;
+  const std::vector<double> joint_position = manipulator.getAllActiveJointPosition();
+  Eigen::MatrixXd jacobian(6, joint_position.size());
+  for (uint8_t index = 0; index < joint_position.size(); index++)
+  {
+    std::vector<double> moved_joint_position = joint_position;
+    moved_joint_position.at(index) = joint_position.at(index) + step;
+    manipulator.setAllActiveJointPosition(moved_joint_position);
+    kinematics.updateForwardKinematics(&manipulator);
+    const KinematicPose forward = manipulator.getComponentKinematicPoseFromWorld(tool_name);
+
+    moved_joint_position.at(index) = joint_position.at(index) - step;
+    manipulator.setAllActiveJointPosition(moved_joint_position);
+    kinematics.updateForwardKinematics(&manipulator);
+    const KinematicPose backward = manipulator.getComponentKinematicPoseFromWorld(tool_name);
+
+    jacobian.block<3, 1>(0, index) = math::positionDifference(forward.position, backward.position) / (2.0 * step);
+    jacobian.block<3, 1>(3, index) = math::orientationDifference(forward.orientation, backward.orientation) / (2.0 * step);
+  }
+  return jacobian;
+}
+
+Pose calcToolPose(Manipulator manipulator, Name tool_name, const std::vector<double> &joint_position)
+{
+  PoEKinematics kinematics;
+  manipulator.setAllActiveJointPosition(joint_position);
+  kinematics.updateForwardKinematics(&manipulator);
+  Pose pose;
+  pose.kinematic = manipulator.getComponentKinematicPoseFromWorld(tool_name);
+  return pose;
+}
+
+// Solved in closed form without the iterative fallback, from a seed close to joint_position
+void expectAnalyticSolution(Manipulator *manipulator, Name tool_name, AnalyticGeometry geometry,
+                            const std::vector<double> &joint_position, double seed_offset)
+{
+  const Pose target_pose = calcToolPose(*manipulator, tool_name, joint_position);
+  std::vector<double> seed_joint_position = joint_position;
+  for (uint8_t index = 0; index < seed_joint_position.size(); index++)
+    seed_joint_position.at(index) += (index % 2 == 0) ? seed_offset : -seed_offset;
+  manipulator->setAllActiveJointPosition(seed_joint_position);
+
+  AnalyticKinematics kinematics;
+  EXPECT_EQ(kinematics.getGeometry(manipulator, tool_name), geometry);
+  std::vector<JointValue> goal_joint_position;
+  ASSERT_TRUE(kinematics.solveInverseKinematics(manipulator, tool_name, target_pose, &goal_joint_position));
+  EXPECT_EQ(kinematics.getLastIteration(), 0);
+  ASSERT_EQ(goal_joint_position.size(), joint_position.size());
+  for (uint8_t index = 0; index < joint_position.size(); index++)
+    EXPECT_NEAR(goal_joint_position.at(index).position, joint_position.at(index), 1E-9);
+}
+
+BatchKinematics::KinematicsFactory damped_least_squares_factory = []() -> Kinematics * { return new DampedLeastSquaresKinematics(); };
+
+void expectSameResult(const std::vector<InverseKinematicsResult> &expected, const std::vector<InverseKinematicsResult> &result)
+{
+  ASSERT_EQ(expected.size(), result.size());
+  for (size_t target = 0; target < expected.size(); target++)
+  {
+    EXPECT_EQ(expected.at(target).solved, result.at(target).solved);
+    ASSERT_EQ(expected.at(target).goal_joint_position.size(), result.at(target).goal_joint_position.size());
+    for (uint8_t index = 0; index < expected.at(target).goal_joint_position.size(); index++)
+      EXPECT_EQ(expected.at(target).goal_joint_position.at(index).position, result.at(target).goal_joint_position.at(index).position);
+  }
+}
+} // namespace
+
+TEST_F(KinematicsTest, UpdateSolvesAgainAfterAVelocityWrite)
+{
+  VelocityKinematics kinematics;
+  kinematics.updateForwardKinematics(&manipulator_);
+  manipulator_.setJointVelocity("joint1", 0.3);
+  kinematics.updateForwardKinematics(&manipulator_);
+  EXPECT_DOUBLE_EQ(manipulator_.getComponentDynamicPoseFromWorld("tool").linear.velocity(0), 0.3);
+  manipulator_.setJointVelocity("joint1", 0.6);
+  kinematics.updateForwardKinematics(&manipulator_);
+  EXPECT_DOUBLE_EQ(manipulator_.getComponentDynamicPoseFromWorld("tool").linear.velocity(0), 0.6);
+}
+
+TEST_F(KinematicsTest, PositionOnlyUpdateSkipsUntilAJointMoves)
+{
+  CountingPoEKinematics kinematics;
+  EXPECT_TRUE(kinematics.isPositionOnly());
+  kinematics.updateForwardKinematics(&manipulator_);
+  kinematics.updateForwardKinematics(&manipulator_);
+  EXPECT_EQ(kinematics.solve_count_, 1);
+
+  manipulator_.setJointVelocity("joint1", 0.3);
+  kinematics.updateForwardKinematics(&manipulator_);
+  EXPECT_EQ(kinematics.solve_count_, 1);
+
+  manipulator_.setJointPosition("joint1", 0.3);
+  kinematics.updateForwardKinematics(&manipulator_);
+  EXPECT_EQ(kinematics.solve_count_, 2);
+
+  CachedKinematics cached_kinematics(&kinematics);
+  EXPECT_TRUE(cached_kinematics.isPositionOnly());
+}
+
+TEST_F(KinematicsTest, PoEJacobianMatchesFiniteDifferences)
+{
+  manipulator_.setAllActiveJointPosition(std::vector<double>{0.3, -0.4, 0.7, 0.2, -0.5, 0.9});
+  PoEKinematics kinematics;
+  const Eigen::MatrixXd jacobian = kinematics.jacobian(&manipulator_, "tool");
+  EXPECT_LT((jacobian - calcNumericalJacobian(manipulator_, "tool")).cwiseAbs().maxCoeff(), 3E-7);
+
+  Eigen::MatrixXd same_pass_jacobian;
+  manipulator_.setJointPosition("joint3", 1.1);
+  ASSERT_TRUE(kinematics.solveForwardKinematicsAndJacobian(&manipulator_, "tool", &same_pass_jacobian));
+  EXPECT_LT((same_pass_jacobian - calcNumericalJacobian(manipulator_, "tool")).cwiseAbs().maxCoeff(), 3E-7);
+}
+
+TEST(PoEKinematicsTest, JacobianOfABranchIsZeroForTheOtherBranch)
+{
+  RobotisManipulator robot;
+  test::addBranchedArm(&robot);
+  Manipulator manipulator = *robot.getManipulator();
+  manipulator.setAllActiveJointPosition(std::vector<double>{0.3, -0.4, 0.7});
+
+  // Active joints are joint1, joint2 and joint3, tool_a is on the joint2 branch and tool_b on the joint3 branch
+  PoEKinematics kinematics;
+  const Eigen::MatrixXd jacobian_a = kinematics.jacobian(&manipulator, "tool_a");
+  EXPECT_LT((jacobian_a - calcNumericalJacobian(manipulator, "tool_a")).cwiseAbs().maxCoeff(), 3E-7);
+  EXPECT_EQ(jacobian_a.col(2).norm(), 0.0);
+  EXPECT_GT(jacobian_a.col(1).norm(), 0.1);
+
+  const Eigen::MatrixXd jacobian_b = kinematics.jacobian(&manipulator, "tool_b");
+  EXPECT_LT((jacobian_b - calcNumericalJacobian(manipulator, "tool_b")).cwiseAbs().maxCoeff(), 3E-7);
+  EXPECT_EQ(jacobian_b.col(1).norm(), 0.0);
+  EXPECT_GT(jacobian_b.col(2).norm(), 0.1);
+}
+
+TEST_F(KinematicsTest, DampedLeastSquaresWarmStartNeedsFewerIterations)
+{
+  const std::vector<Pose> target_pose = makeTargetPose(3);
+  DampedLeastSquaresKinematics kinematics;
+  std::vector<JointValue> goal_joint_position;
+  for (size_t target = 0; target < target_pose.size(); target++)
+  {
+    manipulator_.setAllActiveJointPosition(std::vector<double>(6, 0.0));
+    ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", target_pose.at(target), &goal_joint_position));
+    const uint8_t cold_iteration = kinematics.getLastIteration();
+
+    // Seeded 0.01 rad away from the solution, like the previous tick of a trajectory
+    std::vector<double> seed_joint_position(6);
+    for (uint8_t index = 0; index < 6; index++)
+      seed_joint_position.at(index) = goal_joint_position.at(index).position + 0.01;
+    manipulator_.setAllActiveJointPosition(seed_joint_position);
+    ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", target_pose.at(target), &goal_joint_position));
+    EXPECT_LE(kinematics.getLastIteration(), 2);
+    EXPECT_LT(kinematics.getLastIteration(), cold_iteration);
+  }
+}
+
+#if defined(COUNT_ALLOCATION)
+TEST_F(KinematicsTest, DampedLeastSquaresDoesNotAllocateAfterTheFirstSolve)
+{
+  const std::vector<Pose> target_pose = makeTargetPose(4);
+  DampedLeastSquaresKinematics kinematics;
+  std::vector<JointValue> goal_joint_position;
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", target_pose.at(0), &goal_joint_position));
+
+  for (size_t target = 1; target < target_pose.size(); target++)
+  {
+    allocation_size = 0;
+    count_allocation = true;
+    const bool solved = kinematics.solveInverseKinematics(&manipulator_, "tool", target_pose.at(target), &goal_joint_position);
+    count_allocation = false;
+    ASSERT_TRUE(solved);
+    EXPECT_EQ(allocation_size, 0u);
+  }
+}
+#endif
+
+TEST_F(KinematicsTest, DampedLeastSquaresStepStaysBoundedAtASingularity)
+{
+  // At zero joint4 and joint6 turn about the same axis, the jacobian loses a rank
+  Manipulator moved = manipulator_;
+  moved.setAllActiveJointPosition(std::vector<double>{0.0, 0.0, 0.0, 0.3, 0.02, -0.3});
+  PoEKinematics forward_kinematics;
+  forward_kinematics.updateForwardKinematics(&moved);
+  Pose target_pose;
+  target_pose.kinematic = moved.getComponentKinematicPoseFromWorld("tool");
+
+  DampedLeastSquaresKinematics kinematics;
+  std::vector<JointValue> goal_joint_position;
+  manipulator_.setAllActiveJointPosition(std::vector<double>(6, 0.0));
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", target_pose, &goal_joint_position));
+  EXPECT_LT(kinematics.getLastIteration(), kinematics.getOption().iteration);
+  for (uint8_t index = 0; index < goal_joint_position.size(); index++)
+  {
+    EXPECT_TRUE(std::isfinite(goal_joint_position.at(index).position));
+    EXPECT_LT(std::fabs(goal_joint_position.at(index).position), 1.0);
+  }
+}
+
+TEST(AnalyticKinematicsTest, SolvesTheOpenManipulatorX)
+{
+  RobotisManipulator robot;
+  test::addOpenManipulatorX(&robot);
+  Manipulator manipulator = *robot.getManipulator();
+  expectAnalyticSolution(&manipulator, "gripper", PLANAR_WRIST_GEOMETRY, std::vector<double>{0.4, -0.6, 0.5, 0.7}, 0.05);
+  expectAnalyticSolution(&manipulator, "gripper", PLANAR_WRIST_GEOMETRY, std::vector<double>{-1.2, 0.3, -0.8, 1.1}, 0.05);
+
+  // Moving the base keeps the geometry valid
+  manipulator.setWorldPosition(math::vector3(0.3, -0.2, 0.1));
+  manipulator.setWorldOrientation(math::convertRPYToRotationMatrix(0.2, -0.1, 0.8));
+  expectAnalyticSolution(&manipulator, "gripper", PLANAR_WRIST_GEOMETRY, std::vector<double>{0.4, -0.6, 0.5, 0.7}, 0.05);
+}
+
+TEST(AnalyticKinematicsTest, SolvesTheSphericalWristArm)
+{
+  RobotisManipulator robot;
+  test::addSphericalWristArm(&robot);
+  Manipulator manipulator = *robot.getManipulator();
+  expectAnalyticSolution(&manipulator, "tool", SPHERICAL_WRIST_GEOMETRY, std::vector<double>{0.3, -0.4, 0.7, 0.2, -0.5, 0.9}, 0.05);
+  expectAnalyticSolution(&manipulator, "tool", SPHERICAL_WRIST_GEOMETRY, std::vector<double>{-2.1, 0.8, -1.3, -1.0, 1.2, -0.4}, 0.05);
+
+  manipulator.setWorldPosition(math::vector3(-0.1, 0.4, 0.2));
+  manipulator.setWorldOrientation(math::convertRPYToRotationMatrix(-0.3, 0.2, -1.1));
+  expectAnalyticSolution(&manipulator, "tool", SPHERICAL_WRIST_GEOMETRY, std::vector<double>{0.3, -0.4, 0.7, 0.2, -0.5, 0.9}, 0.05);
+}
+
+TEST(AnalyticKinematicsTest, TriesTheNextBranchBeforeFallingBack)
+{
+  // From this seed the closest branch within the limits misses the target pose
+  RobotisManipulator robot;
+  test::addOpenManipulatorX(&robot);
+  Manipulator manipulator = *robot.getManipulator();
+  const Pose target_pose = calcToolPose(manipulator, "gripper", std::vector<double>{-1.291, 0.078, -0.923, 1.171});
+
+  manipulator.setAllActiveJointPosition(std::vector<double>{2.696, -2.484, 0.979, -0.907});
+  AnalyticKinematics kinematics;
+  std::vector<JointValue> goal_joint_position;
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator, "gripper", target_pose, &goal_joint_position));
+  EXPECT_EQ(kinematics.getLastIteration(), 0);
+
+  const std::vector<Name> joint_name = manipulator.getAllActiveJointComponentName();
+  std::vector<double> joint_position;
+  for (uint8_t index = 0; index < goal_joint_position.size(); index++)
+  {
+    const Limit limit = manipulator.getComponent(joint_name.at(index)).joint_constant.position_limit;
+    EXPECT_LE(goal_joint_position.at(index).position, limit.maximum);
+    EXPECT_GE(goal_joint_position.at(index).position, limit.minimum);
+    joint_position.push_back(goal_joint_position.at(index).position);
+  }
+  const Pose goal_pose = calcToolPose(manipulator, "gripper", joint_position);
+  EXPECT_LT((goal_pose.kinematic.position - target_pose.kinematic.position).norm(), 1E-9);
+  EXPECT_LT((goal_pose.kinematic.orientation - target_pose.kinematic.orientation).norm(), 1E-9);
+}
+
+TEST_F(KinematicsTest, BatchGivesTheSameResultsOnAnyNumberOfThreads)
+{
+  const std::vector<Pose> target_pose = makeTargetPose(64);
+  BatchKinematics single_thread(damped_least_squares_factory, 1);
+  std::vector<InverseKinematicsResult> expected;
+  single_thread.solveInverseKinematics(manipulator_, "tool", target_pose, &expected);
+  size_t solved_size = 0;
+  for (size_t target = 0; target < expected.size(); target++)
+    solved_size += expected.at(target).solved ? 1 : 0;
+  EXPECT_GT(solved_size, target_pose.size() / 2);
+
+  for (uint8_t thread_size = 2; thread_size <= 5; thread_size += 3)
+  {
+    BatchKinematics batch(damped_least_squares_factory, thread_size);
+    ASSERT_EQ(batch.getThreadSize(), thread_size);
+    std::vector<InverseKinematicsResult> result;
+    batch.solveInverseKinematics(manipulator_, "tool", target_pose, &result);
+    expectSameResult(expected, result);
+  }
+}
+
+TEST_F(KinematicsTest, BatchesBackToBackDoNotDependOnEachOther)
+{
+  const std::vector<Pose> target_pose = makeTargetPose(40);
+  const std::vector<Pose> other_target_pose(target_pose.rbegin(), target_pose.rbegin() + 25);
+  BatchKinematics single_thread(damped_least_squares_factory, 1);
+  std::vector<InverseKinematicsResult> expected, other_expected;
+  single_thread.solveInverseKinematics(manipulator_, "tool", target_pose, &expected);
+  single_thread.solveInverseKinematics(manipulator_, "tool", other_target_pose, &other_expected);
+
+  BatchKinematics batch(damped_least_squares_factory, 4);
+  std::vector<InverseKinematicsResult> result;
+  for (uint8_t repeat = 0; repeat < 20; repeat++)
+  {
+    batch.solveInverseKinematics(manipulator_, "tool", target_pose, &result);
+    expectSameResult(expected, result);
+    batch.solveInverseKinematics(manipulator_, "tool", other_target_pose, &result);
+    expectSameResult(other_expected, result);
+  }
+}
+
+TEST_F(KinematicsTest, BatchSmallerThanTheThreadCount)
+{
+  const std::vector<Pose> target_pose = makeTargetPose(2);
+  BatchKinematics single_thread(damped_least_squares_factory, 1);
+  std::vector<InverseKinematicsResult> expected;
+  single_thread.solveInverseKinematics(manipulator_, "tool", target_pose, &expected);
+
+  BatchKinematics batch(damped_least_squares_factory, 6);
+  std::vector<InverseKinematicsResult> result;
+  batch.solveInverseKinematics(manipulator_, "tool", target_pose, &result);
+  expectSameResult(expected, result);
+
+  EXPECT_TRUE(batch.solveInverseKinematics(manipulator_, "tool", std::vector<Pose>(), &result));
+  EXPECT_TRUE(result.empty());
+}
+
+TEST_F(KinematicsTest, BatchStopsItsThreadsWhileIdle)
+{
+  for (uint8_t repeat = 0; repeat < 20; repeat++)
+  {
+    BatchKinematics idle_batch(damped_least_squares_factory, 4);
+  }
+  BatchKinematics batch(damped_least_squares_factory, 4);
+  std::vector<InverseKinematicsResult> result;
+  batch.solveInverseKinematics(manipulator_, "tool", makeTargetPose(8), &result);
+  EXPECT_EQ(result.size(), 8u);
+}
+
+TEST_F(KinematicsTest, CacheHitReturnsTheStoredSolutionWithoutSolving)
+{
+  CountingDampedLeastSquaresKinematics solver;
+  CachedKinematics kinematics(&solver);
+  const Pose target_pose = calcToolPose(manipulator_, "tool", std::vector<double>{0.3, -0.2, 0.4, 0.1, -0.3, 0.2});
+  manipulator_.setAllActiveJointPosition(std::vector<double>(6, 0.1));
+
+  std::vector<JointValue> solved, cached;
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", target_pose, &solved));
+  EXPECT_EQ(kinematics.getMissCount(), 1u);
+  EXPECT_EQ(kinematics.getCacheSize(), 1u);
+
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", target_pose, &cached));
+  EXPECT_EQ(kinematics.getHitCount(), 1u);
+  EXPECT_EQ(solver.solve_count_, 1);
+  ASSERT_EQ(cached.size(), solved.size());
+  for (uint8_t index = 0; index < solved.size(); index++)
+    EXPECT_EQ(cached.at(index).position, solved.at(index).position);
+}
+
+TEST_F(KinematicsTest, CacheMissesOnAnotherTargetOrSeed)
+{
+  CountingDampedLeastSquaresKinematics solver;
+  CachedKinematics kinematics(&solver);
+  const Pose target_pose = calcToolPose(manipulator_, "tool", std::vector<double>{0.3, -0.2, 0.4, 0.1, -0.3, 0.2});
+  const Pose other_target_pose = calcToolPose(manipulator_, "tool", std::vector<double>{0.2, -0.1, 0.3, 0.2, -0.2, 0.1});
+  manipulator_.setAllActiveJointPosition(std::vector<double>(6, 0.1));
+
+  std::vector<JointValue> goal_joint_position;
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", target_pose, &goal_joint_position));
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", other_target_pose, &goal_joint_position));
+  EXPECT_EQ(kinematics.getMissCount(), 2u);
+
+  // A seed in another cell of seed_resolution solves again
+  manipulator_.setAllActiveJointPosition(std::vector<double>(6, 0.3));
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", target_pose, &goal_joint_position));
+  EXPECT_EQ(kinematics.getMissCount(), 3u);
+  EXPECT_EQ(kinematics.getHitCount(), 0u);
+  EXPECT_EQ(solver.solve_count_, 3);
+  EXPECT_EQ(kinematics.getCacheSize(), 3u);
+}
+
+TEST_F(KinematicsTest, CacheDropsTheLeastRecentlyUsedSolution)
+{
+  CountingDampedLeastSquaresKinematics solver;
+  CachedKinematics kinematics(&solver);
+  KinematicsCacheOption option = kinematics.getCacheOption();
+  option.capacity = 2;
+  kinematics.setCacheOption(option);
+  const Pose first = calcToolPose(manipulator_, "tool", std::vector<double>{0.3, -0.2, 0.4, 0.1, -0.3, 0.2});
+  const Pose second = calcToolPose(manipulator_, "tool", std::vector<double>{0.2, -0.1, 0.3, 0.2, -0.2, 0.1});
+  const Pose third = calcToolPose(manipulator_, "tool", std::vector<double>{0.1, 0.0, 0.2, 0.3, -0.1, 0.0});
+  manipulator_.setAllActiveJointPosition(std::vector<double>(6, 0.1));
+
+  std::vector<JointValue> goal_joint_position;
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", first, &goal_joint_position));
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", second, &goal_joint_position));
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", first, &goal_joint_position));
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", third, &goal_joint_position));
+  EXPECT_EQ(kinematics.getCacheSize(), 2u);
+  EXPECT_EQ(solver.solve_count_, 3);
+
+  // first was used after second, so second was dropped
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", first, &goal_joint_position));
+  EXPECT_EQ(solver.solve_count_, 3);
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", second, &goal_joint_position));
+  EXPECT_EQ(solver.solve_count_, 4);
+}
+
+TEST_F(KinematicsTest, CacheIsClearedWhenTheModelChanges)
+{
+  CountingDampedLeastSquaresKinematics solver;
+  CachedKinematics kinematics(&solver);
+  const Pose target_pose = calcToolPose(manipulator_, "tool", std::vector<double>{0.3, -0.2, 0.4, 0.1, -0.3, 0.2});
+  manipulator_.setAllActiveJointPosition(std::vector<double>(6, 0.1));
+
+  std::vector<JointValue> goal_joint_position;
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", target_pose, &goal_joint_position));
+  const uint32_t revision = manipulator_.getModelRevision();
+  manipulator_.setTorqueCoefficient("joint1", 2.0);
+  ASSERT_NE(manipulator_.getModelRevision(), revision);
+
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", target_pose, &goal_joint_position));
+  EXPECT_EQ(kinematics.getHitCount(), 0u);
+  EXPECT_EQ(solver.solve_count_, 2);
+  EXPECT_EQ(kinematics.getCacheSize(), 1u);
+}
+
+TEST_F(KinematicsTest, CacheMissesWhenTheWorldPoseMoves)
+{
+  CountingDampedLeastSquaresKinematics solver;
+  CachedKinematics kinematics(&solver);
+  const Pose target_pose = calcToolPose(manipulator_, "tool", std::vector<double>{0.3, -0.2, 0.4, 0.1, -0.3, 0.2});
+  manipulator_.setAllActiveJointPosition(std::vector<double>(6, 0.1));
+
+  std::vector<JointValue> goal_joint_position;
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", target_pose, &goal_joint_position));
+  manipulator_.setWorldPosition(math::vector3(0.0, 0.0, 0.01));
+
+  // The same target in the world is another goal for the joints
+  ASSERT_TRUE(kinematics.solveInverseKinematics(&manipulator_, "tool", target_pose, &goal_joint_position));
+  EXPECT_EQ(kinematics.getHitCount(), 0u);
+  EXPECT_EQ(solver.solve_count_, 2);
+  std::vector<double> joint_position;
+  for (uint8_t index = 0; index < goal_joint_position.size(); index++)
+    joint_position.push_back(goal_joint_position.at(index).position);
+  EXPECT_LT((calcToolPose(manipulator_, "tool", joint_position).kinematic.position - target_pose.kinematic.position).norm(), 1E-5);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,79 @@
+/*******************************************************************************
+* Copyright 2018 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/* Authors: Darby Lim, Hye-Jong KIM, Ryan Shim, Yong-Ho Na */
+
+// Manipulators shared by the tests.
+
+#ifndef ROBOTIS_MANIPULATOR_TEST_ROBOT_H_
+#define ROBOTIS_MANIPULATOR_TEST_ROBOT_H_
+
+#include "../include/robotis_manipulator/robotis_manipulator.h"
+
+namespace robotis_manipulator
+{
+namespace test
+{
+/**
+ * @brief addOpenManipulatorX 4-DOF arm with the OpenManipulator-X geometry and joint limits, tool "gripper"
+ */
+inline void addOpenManipulatorX(RobotisManipulator *robot)
+{
+  robot->addWorld("world", "joint1");
+  robot->addJoint("joint1", "world", "joint2", math::vector3(0.012, 0.0, 0.017), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0),
+                  math::vector3(0.0, 0.0, 1.0), 11, M_PI, -M_PI);
+  robot->addJoint("joint2", "joint1", "joint3", math::vector3(0.0, 0.0, 0.0595), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0),
+                  math::vector3(0.0, 1.0, 0.0), 12, M_PI_2, -2.05);
+  robot->addJoint("joint3", "joint2", "joint4", math::vector3(0.024, 0.0, 0.128), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0),
+                  math::vector3(0.0, 1.0, 0.0), 13, 1.53, -M_PI_2);
+  robot->addJoint("joint4", "joint3", "gripper", math::vector3(0.124, 0.0, 0.0), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0),
+                  math::vector3(0.0, 1.0, 0.0), 14, 2.0, -1.8);
+  robot->addTool("gripper", "joint4", math::vector3(0.126, 0.0, 0.0), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0),
+                 15, 0.01, -0.01, -0.015);
+}
+
+/**
+ * @brief addSphericalWristArm 6-DOF arm whose last three axes meet in one point, tool "tool"
+ */
+inline void addSphericalWristArm(RobotisManipulator *robot)
+{
+  robot->addWorld("world", "joint1");
+  robot->addJoint("joint1", "world", "joint2", math::vector3(0.0, 0.0, 0.1), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), math::vector3(0.0, 0.0, 1.0), 11);
+  robot->addJoint("joint2", "joint1", "joint3", math::vector3(0.0, 0.0, 0.1), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), math::vector3(0.0, 1.0, 0.0), 12);
+  robot->addJoint("joint3", "joint2", "joint4", math::vector3(0.03, 0.0, 0.3), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), math::vector3(0.0, 1.0, 0.0), 13);
+  robot->addJoint("joint4", "joint3", "joint5", math::vector3(0.1, 0.0, 0.0), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), math::vector3(1.0, 0.0, 0.0), 14);
+  robot->addJoint("joint5", "joint4", "joint6", math::vector3(0.15, 0.0, 0.0), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), math::vector3(0.0, 1.0, 0.0), 15);
+  robot->addJoint("joint6", "joint5", "tool", math::vector3(0.0, 0.0, 0.0), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), math::vector3(1.0, 0.0, 0.0), 16);
+  robot->addTool("tool", "joint6", math::vector3(0.08, 0.0, 0.0), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), 17);
+}
+
+/**
+ * @brief addBranchedArm 3-DOF arm with two branches after joint1: joint2 moves "tool_a" and joint3 moves "tool_b"
+ */
+inline void addBranchedArm(RobotisManipulator *robot)
+{
+  robot->addWorld("world", "joint1");
+  robot->addJoint("joint1", "world", "joint2", math::vector3(0.0, 0.0, 0.1), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), math::vector3(0.0, 0.0, 1.0), 11);
+  robot->addJoint("joint2", "joint1", "tool_a", math::vector3(0.0, 0.0, 0.1), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), math::vector3(0.0, 1.0, 0.0), 12);
+  robot->addJoint("joint3", "joint1", "tool_b", math::vector3(0.1, 0.0, 0.1), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), math::vector3(1.0, 0.0, 0.0), 13);
+  robot->addComponentChild("joint1", "joint3");
+  robot->addTool("tool_a", "joint2", math::vector3(0.2, 0.0, 0.0), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), 14);
+  robot->addTool("tool_b", "joint3", math::vector3(0.0, 0.2, 0.0), math::convertRPYToRotationMatrix(0.0, 0.0, 0.0), 15);
+}
+} // namespace test
+} // namespace robotis_manipulator
+
+#endif // ROBOTIS_MANIPULATOR_TEST_ROBOT_H_
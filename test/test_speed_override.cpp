@@ -0,0 +1,185 @@
+/*******************************************************************************
+* Copyright 2018 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/* Authors: Darby Lim, Hye-Jong KIM, Ryan Shim, Yong-Ho Na */
+
+// Speed override of the trajectory time base, driven through RobotisManipulator at a 1 ms control period,
+// and copies of the objects holding it or a retarget.
+
+#include <gtest/gtest.h>
+
+#include "../include/robotis_manipulator/robotis_manipulator_kinematics.h"
+#include "test_robot.h"
+
+using namespace robotis_manipulator;
+
+namespace
+{
+const double CONTROL_PERIOD = 0.001;
+const double MOVE_TIME = 2.0;
+// Peak joint velocity of the move is 1.875 / MOVE_TIME rad/s, so no tick at full speed moves further than this
+const double MAX_STEP = 1.875 / MOVE_TIME * CONTROL_PERIOD * 1.01;
+
+// Effort of each joint is its velocity plus ten times its acceleration, to see what the dynamics were given
+class VelocityDynamics : public Dynamics
+{
+public:
+  virtual bool setOption(STRING param_name, const void *arg) { return true; }
+  virtual bool setEnvironments(STRING param_name, const void *arg) { return true; }
+  virtual bool solveForwardDynamics(Manipulator *manipulator, std::map<Name, double> joint_torque) { return false; }
+  virtual bool solveInverseDynamics(Manipulator manipulator, std::map<Name, double> *joint_torque)
+  {
+    const std::vector<Name> &joint_name = manipulator.getAllActiveJointComponentName();
+    for (uint8_t index = 0; index < joint_name.size(); index++)
+    {
+      const JointValue joint_value = manipulator.getJointValue(joint_name.at(index));
+      (*joint_torque)[joint_name.at(index)] = joint_value.velocity + 10.0 * joint_value.acceleration;
+    }
+    return true;
+  }
+};
+
+class SpeedOverrideTest : public testing::Test
+{
+protected:
+  RobotisManipulator robot_;
+  PoEKinematics kinematics_;
+  VelocityDynamics dynamics_;
+
+  virtual void SetUp()
+  {
+    test::addSphericalWristArm(&robot_);
+    robot_.addKinematics(&kinematics_);
+    robot_.getJointGoalValueFromTrajectory(0.0);
+    ASSERT_TRUE(robot_.makeJointTrajectory(std::vector<double>(6, 1.0), MOVE_TIME));
+  }
+
+  // Runs the control loop from tick to the end of the move, calling change(tick) before every tick.
+  // Returns the largest position step between two ticks and the final goal.
+  template <typename Change>
+  double run(Change change, JointWaypoint *final_way_point, int option = DYNAMICS_ALL_SOVING)
+  {
+    double max_step = 0.0;
+    JointWaypoint previous;
+    for (int tick = 1; tick < 20000; tick++)
+    {
+      change(tick);
+      JointWaypoint way_point = robot_.getJointGoalValueFromTrajectory(tick * CONTROL_PERIOD, option);
+      if (way_point.empty())
+        break;
+      if (!previous.empty())
+        max_step = std::max(max_step, std::fabs(way_point.at(0).position - previous.at(0).position));
+      previous = way_point;
+    }
+    *final_way_point = previous;
+    return max_step;
+  }
+};
+} // namespace
+
+TEST_F(SpeedOverrideTest, HalfSpeedPauseAndDoubleSpeedStayContinuous)
+{
+  JointWaypoint final_way_point;
+  double max_step = run([this](int tick) {
+                          if (tick == 500) robot_.setSpeedOverride(0.5, 1.0);
+                          if (tick == 2000) robot_.setSpeedOverride(0.0, 2.0);
+                          if (tick == 3000) robot_.setSpeedOverride(2.0, 4.0);
+                        }, &final_way_point);
+  EXPECT_LT(max_step, 2.0 * MAX_STEP);
+  EXPECT_NEAR(final_way_point.at(0).position, 1.0, 1E-9);
+}
+
+TEST_F(SpeedOverrideTest, ReturnToFullSpeedKeepsTheIntegratedTime)
+{
+  // One second at half speed is half a second of trajectory time, full speed then continues from there
+  JointWaypoint final_way_point;
+  double tick_time_at_return = 0.0;
+  double max_step = run([this, &tick_time_at_return](int tick) {
+                          if (tick == 1) robot_.setSpeedOverride(0.5, 0.0);
+                          if (tick == 1001)
+                          {
+                            tick_time_at_return = robot_.getTrajectory()->getTickTime();
+                            robot_.setSpeedOverride(1.0, 0.0);
+                          }
+                        }, &final_way_point);
+  EXPECT_NEAR(tick_time_at_return, 0.5, 1E-9);
+  EXPECT_LT(max_step, MAX_STEP);
+  EXPECT_NEAR(final_way_point.at(0).position, 1.0, 1E-9);
+}
+
+TEST_F(SpeedOverrideTest, EffortFollowsTheScaledVelocity)
+{
+  robot_.addDynamics(&dynamics_);
+  robot_.setSpeedOverride(0.5, 0.0);
+  for (int tick = 1; tick < 1000; tick++)
+  {
+    JointWaypoint way_point = robot_.getJointGoalValueFromTrajectory(tick * CONTROL_PERIOD, DYNAMICS_ALL_SOVING);
+    ASSERT_FALSE(way_point.empty());
+    for (uint8_t index = 0; index < way_point.size(); index++)
+      ASSERT_NEAR(way_point.at(index).effort, way_point.at(index).velocity + 10.0 * way_point.at(index).acceleration, 1E-12);
+  }
+}
+
+TEST_F(SpeedOverrideTest, CopyOfTheTrajectoryKeepsTheSpeedOverride)
+{
+  robot_.setSpeedOverride(0.5, 2.0);
+  robot_.getJointGoalValueFromTrajectory(CONTROL_PERIOD);
+  Trajectory copy(*robot_.getTrajectory());
+  EXPECT_DOUBLE_EQ(copy.getSpeedOverride(), robot_.getTrajectory()->getSpeedOverride());
+  EXPECT_DOUBLE_EQ(copy.getTickTime(), robot_.getTrajectory()->getTickTime());
+
+  // Both go on at the same speed from the copy on
+  Trajectory assigned;
+  assigned = copy;
+  copy.setPresentTime(10 * CONTROL_PERIOD);
+  assigned.setPresentTime(10 * CONTROL_PERIOD);
+  robot_.getTrajectory()->setPresentTime(10 * CONTROL_PERIOD);
+  EXPECT_DOUBLE_EQ(copy.getTickTime(), robot_.getTrajectory()->getTickTime());
+  EXPECT_DOUBLE_EQ(assigned.getTickTime(), robot_.getTrajectory()->getTickTime());
+  EXPECT_DOUBLE_EQ(assigned.getSpeedOverride(), robot_.getTrajectory()->getSpeedOverride());
+}
+
+TEST_F(SpeedOverrideTest, CopyOfTheManipulatorTakesAReadyRetarget)
+{
+  ASSERT_TRUE(robot_.retargetJointTrajectory(std::vector<double>(6, -1.0), MOVE_TIME));
+  RobotisManipulator copy(robot_);
+  RobotisManipulator assigned;
+  assigned = robot_;
+
+  // The copies retarget on their first tick, like the original
+  JointWaypoint final_way_point;
+  run([](int tick) {}, &final_way_point);
+  EXPECT_NEAR(final_way_point.at(0).position, -1.0, 1E-9);
+  for (RobotisManipulator *robot : {&copy, &assigned})
+  {
+    JointWaypoint way_point;
+    for (int tick = 1; tick < 20000; tick++)
+    {
+      JointWaypoint next_way_point = robot->getJointGoalValueFromTrajectory(tick * CONTROL_PERIOD);
+      if (next_way_point.empty())
+        break;
+      way_point = next_way_point;
+    }
+    ASSERT_FALSE(way_point.empty());
+    EXPECT_NEAR(way_point.at(0).position, -1.0, 1E-9);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,149 @@
+/*******************************************************************************
+* Copyright 2018 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/* Authors: Darby Lim, Hye-Jong KIM, Ryan Shim, Yong-Ho Na */
+
+// Continuity of multi-segment task trajectories at their via points, and how RobotisManipulator checks them.
+
+#include <gtest/gtest.h>
+
+#include "../include/robotis_manipulator/robotis_manipulator_kinematics.h"
+#include "../include/robotis_manipulator/robotis_manipulator_trajectory_generator.h"
+#include "test_robot.h"
+
+using namespace robotis_manipulator;
+
+namespace
+{
+const double KNOT_TIME = 1.0;
+const double EPSILON_TIME = 1E-6;
+
+TaskWaypoint makeTaskWaypoint(double x, const Eigen::Matrix3d &orientation)
+{
+  TaskWaypoint way_point = {};
+  way_point.kinematic.position = math::vector3(x, 0.0, 0.0);
+  way_point.kinematic.orientation = orientation;
+  way_point.dynamic.linear.velocity = Eigen::Vector3d::Zero();
+  way_point.dynamic.linear.acceleration = Eigen::Vector3d::Zero();
+  way_point.dynamic.angular.velocity = Eigen::Vector3d::Zero();
+  way_point.dynamic.angular.acceleration = Eigen::Vector3d::Zero();
+  return way_point;
+}
+
+// Samples just before and just after the via knot of a two segment trajectory
+void sampleAroundKnot(OrientationInterpolation orientation_interpolation, const Eigen::Matrix3d &via, const Eigen::Matrix3d &goal,
+                      TaskWaypoint *before, TaskWaypoint *after)
+{
+  Trajectory trajectory;
+  trajectory.setTrajectoryType(TASK_TRAJECTORY);
+  trajectory.setOrientationInterpolation(orientation_interpolation);
+  std::vector<TaskWaypoint> via_way_point;
+  via_way_point.push_back(makeTaskWaypoint(0.1, via));
+  via_way_point.push_back(makeTaskWaypoint(0.2, goal));
+  ASSERT_TRUE(trajectory.makeTaskTrajectory(makeTaskWaypoint(0.0, Eigen::Matrix3d::Identity()), via_way_point, std::vector<double>(2, KNOT_TIME)));
+
+  Eigen::VectorXd tick(2);
+  tick << KNOT_TIME - EPSILON_TIME, KNOT_TIME + EPSILON_TIME;
+  std::vector<TaskWaypoint> way_point;
+  ASSERT_TRUE(trajectory.sampleTaskWaypoint(tick, &way_point));
+  *before = way_point.at(0);
+  *after = way_point.at(1);
+}
+
+// Keeps the joint positions every solve starts from and the solutions
+class SeedRecordingKinematics : public DampedLeastSquaresKinematics
+{
+public:
+  std::vector<std::vector<double>> seed_;
+  std::vector<std::vector<double>> solution_;
+
+  virtual bool solveInverseKinematics(Manipulator *manipulator, Name tool_name, Pose target_pose, std::vector<JointValue> *goal_joint_position)
+  {
+    seed_.push_back(manipulator->getAllActiveJointPosition());
+    if (!DampedLeastSquaresKinematics::solveInverseKinematics(manipulator, tool_name, target_pose, goal_joint_position))
+      return false;
+    std::vector<double> solution;
+    for (uint8_t index = 0; index < goal_joint_position->size(); index++)
+      solution.push_back(goal_joint_position->at(index).position);
+    solution_.push_back(solution);
+    return true;
+  }
+};
+
+void expectContinuous(const TaskWaypoint &before, const TaskWaypoint &after)
+{
+  EXPECT_LT((before.kinematic.position - after.kinematic.position).norm(), 1E-5);
+  EXPECT_LT((before.kinematic.orientation - after.kinematic.orientation).norm(), 1E-5);
+  EXPECT_LT((before.dynamic.linear.velocity - after.dynamic.linear.velocity).norm(), 1E-5);
+  EXPECT_LT((before.dynamic.angular.velocity - after.dynamic.angular.velocity).norm(), 1E-5);
+}
+} // namespace
+
+TEST(TaskViaPointTest, SlerpKeepsTurningThroughAViaPointOnTheSameAxis)
+{
+  TaskWaypoint before, after;
+  sampleAroundKnot(SLERP_INTERPOLATION, math::convertRPYToRotationMatrix(0.0, 0.0, 0.5), math::convertRPYToRotationMatrix(0.0, 0.0, 1.0), &before, &after);
+  expectContinuous(before, after);
+  EXPECT_NEAR(after.dynamic.angular.velocity(2), 0.5, 1E-5);
+}
+
+TEST(TaskViaPointTest, SlerpStopsTheRotationAtAViaPointBetweenTwoAxes)
+{
+  // Roll and yaw both keep increasing, but the two segments turn about different axes
+  TaskWaypoint before, after;
+  sampleAroundKnot(SLERP_INTERPOLATION, math::convertRPYToRotationMatrix(0.3, 0.0, 0.3), math::convertRPYToRotationMatrix(0.6, 0.0, 0.6), &before, &after);
+  expectContinuous(before, after);
+  EXPECT_LT(after.dynamic.angular.velocity.norm(), 1E-5);
+  EXPECT_NEAR(after.dynamic.linear.velocity(0), 0.1, 1E-5);
+}
+
+TEST(TaskViaPointTest, RpyBlendsTheRotationThroughAViaPoint)
+{
+  TaskWaypoint before, after;
+  sampleAroundKnot(RPY_INTERPOLATION, math::convertRPYToRotationMatrix(0.3, 0.0, 0.3), math::convertRPYToRotationMatrix(0.6, 0.0, 0.6), &before, &after);
+  expectContinuous(before, after);
+  EXPECT_GT(after.dynamic.angular.velocity.norm(), 0.1);
+}
+
+TEST(TaskViaPointTest, EachViaPointIsSolvedFromThePreviousOne)
+{
+  RobotisManipulator robot;
+  test::addSphericalWristArm(&robot);
+  SeedRecordingKinematics kinematics;
+  robot.addKinematics(&kinematics);
+  robot.getJointGoalValueFromTrajectory(0.0);
+
+  std::vector<KinematicPose> via_pose;
+  PoEKinematics forward_kinematics;
+  Manipulator manipulator = *robot.getManipulator();
+  manipulator.setAllActiveJointPosition(std::vector<double>{0.2, -0.1, 0.3, 0.1, -0.2, 0.1});
+  forward_kinematics.updateForwardKinematics(&manipulator);
+  via_pose.push_back(manipulator.getComponentKinematicPoseFromWorld("tool"));
+  manipulator.setAllActiveJointPosition(std::vector<double>{0.4, -0.2, 0.6, 0.2, -0.4, 0.2});
+  forward_kinematics.updateForwardKinematics(&manipulator);
+  via_pose.push_back(manipulator.getComponentKinematicPoseFromWorld("tool"));
+
+  ASSERT_TRUE(robot.makeTaskTrajectory("tool", via_pose, std::vector<double>(2, KNOT_TIME)));
+  ASSERT_GE(kinematics.seed_.size(), 2u);
+  EXPECT_EQ(kinematics.seed_.at(0), robot.getManipulator()->getAllActiveJointPosition());
+  EXPECT_EQ(kinematics.seed_.at(1), kinematics.solution_.at(0));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,147 @@
+/*******************************************************************************
+* Copyright 2018 ROBOTIS CO., LTD.
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+/* Authors: Darby Lim, Hye-Jong KIM, Ryan Shim, Yong-Ho Na */
+
+// Accuracy of the float trajectory instantiation against the double one, for float builds on embedded targets.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <random>
+
+#include "../include/robotis_manipulator/robotis_manipulator.h"
+
+using namespace robotis_manipulator;
+
+namespace
+{
+const int TRIAL_SIZE = 200;
+const int SAMPLE_SIZE = 200;
+const int JOINT_SIZE = 6;
+
+TaskWaypoint randomTaskWaypoint(std::mt19937 *generator)
+{
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  TaskWaypoint task_way_point;
+  task_way_point.kinematic.position = 0.3 * Eigen::Vector3d(uniform(*generator), uniform(*generator), uniform(*generator));
+  task_way_point.kinematic.orientation = math::convertRPYToRotationMatrix(uniform(*generator), 0.6 * uniform(*generator), uniform(*generator));
+  task_way_point.dynamic.linear.velocity = Eigen::Vector3d::Zero();
+  task_way_point.dynamic.linear.acceleration = Eigen::Vector3d::Zero();
+  task_way_point.dynamic.angular.velocity = Eigen::Vector3d::Zero();
+  task_way_point.dynamic.angular.acceleration = Eigen::Vector3d::Zero();
+  return task_way_point;
+}
+
+void compareTaskTrajectory(OrientationInterpolation orientation_interpolation, double *position_error, double *orientation_error)
+{
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<double> move_time(1.0, 5.0);
+  *position_error = 0.0;
+  *orientation_error = 0.0;
+  for (int trial = 0; trial < TRIAL_SIZE; trial++)
+  {
+    const double time = move_time(generator);
+    const TaskWaypoint start = randomTaskWaypoint(&generator);
+    const TaskWaypoint goal = randomTaskWaypoint(&generator);
+
+    BasicTaskTrajectory<float> float_trajectory;
+    BasicTaskTrajectory<double> double_trajectory;
+    float_trajectory.setOrientationInterpolation(orientation_interpolation);
+    double_trajectory.setOrientationInterpolation(orientation_interpolation);
+    ASSERT_TRUE(float_trajectory.makeTaskTrajectory(time, start, goal));
+    ASSERT_TRUE(double_trajectory.makeTaskTrajectory(time, start, goal));
+
+    for (int sample = 0; sample <= SAMPLE_SIZE; sample++)
+    {
+      const double tick = time * sample / SAMPLE_SIZE;
+      const TaskWaypoint float_way_point = float_trajectory.getTaskWaypoint(tick);
+      const TaskWaypoint double_way_point = double_trajectory.getTaskWaypoint(tick);
+      *position_error = std::max(*position_error, (float_way_point.kinematic.position - double_way_point.kinematic.position).norm());
+      *orientation_error = std::max(*orientation_error, math::orientationDifference(double_way_point.kinematic.orientation,
+                                                                                    float_way_point.kinematic.orientation).norm());
+    }
+  }
+}
+} // namespace
+
+TEST(TrajectoryPrecision, JointTrajectoryFloatAgainstDouble)
+{
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  std::uniform_real_distribution<double> move_time(1.0, 5.0);
+
+  double position_error = 0.0, velocity_error = 0.0, acceleration_error = 0.0;
+  for (int trial = 0; trial < TRIAL_SIZE; trial++)
+  {
+    const double time = move_time(generator);
+    JointWaypoint start(JOINT_SIZE), goal(JOINT_SIZE);
+    for (int index = 0; index < JOINT_SIZE; index++)
+    {
+      start.at(index).position = 3.0 * uniform(generator);
+      start.at(index).velocity = 0.5 * uniform(generator);
+      start.at(index).acceleration = 0.5 * uniform(generator);
+      goal.at(index).position = 3.0 * uniform(generator);
+      goal.at(index).velocity = 0.5 * uniform(generator);
+      goal.at(index).acceleration = 0.5 * uniform(generator);
+    }
+
+    BasicJointTrajectory<float> float_trajectory;
+    BasicJointTrajectory<double> double_trajectory;
+    ASSERT_TRUE(float_trajectory.makeJointTrajectory(time, start, goal));
+    ASSERT_TRUE(double_trajectory.makeJointTrajectory(time, start, goal));
+
+    JointWaypoint float_way_point, double_way_point;
+    for (int sample = 0; sample <= SAMPLE_SIZE; sample++)
+    {
+      const double tick = time * sample / SAMPLE_SIZE;
+      float_trajectory.getJointWaypoint(tick, &float_way_point);
+      double_trajectory.getJointWaypoint(tick, &double_way_point);
+      for (int index = 0; index < JOINT_SIZE; index++)
+      {
+        position_error = std::max(position_error, std::fabs(float_way_point.at(index).position - double_way_point.at(index).position));
+        velocity_error = std::max(velocity_error, std::fabs(float_way_point.at(index).velocity - double_way_point.at(index).velocity));
+        acceleration_error = std::max(acceleration_error, std::fabs(float_way_point.at(index).acceleration - double_way_point.at(index).acceleration));
+      }
+    }
+  }
+
+  std::printf("joint float against double: position %.2e rad, velocity %.2e rad/s, acceleration %.2e rad/s^2\n",
+              position_error, velocity_error, acceleration_error);
+  EXPECT_LT(position_error, 1E-4);
+  EXPECT_LT(velocity_error, 1E-4);
+  EXPECT_LT(acceleration_error, 5E-4);
+}
+
+TEST(TrajectoryPrecision, TaskTrajectoryFloatAgainstDouble)
+{
+  double position_error, orientation_error;
+  compareTaskTrajectory(RPY_INTERPOLATION, &position_error, &orientation_error);
+  std::printf("task float against double, RPY: position %.2e m, orientation %.2e rad\n", position_error, orientation_error);
+  EXPECT_LT(position_error, 1E-5);
+  EXPECT_LT(orientation_error, 5E-5);
+
+  compareTaskTrajectory(SLERP_INTERPOLATION, &position_error, &orientation_error);
+  std::printf("task float against double, SLERP: position %.2e m, orientation %.2e rad\n", position_error, orientation_error);
+  EXPECT_LT(position_error, 1E-5);
+  EXPECT_LT(orientation_error, 5E-5);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}